@@ -0,0 +1,132 @@
+#ifndef LHCBMATH_CHOOSECACHE_H
+#define LHCBMATH_CHOOSECACHE_H 1
+// ============================================================================
+// Include files
+// ============================================================================
+// STD & STL
+// ============================================================================
+#include <cstddef>
+#include <cstdint>
+// ============================================================================
+// local
+// ============================================================================
+#include "LHCbMath/Choose.h"
+// ============================================================================
+/** @file
+ *  Bounded concurrent memoization of the binomial coefficients
+ */
+// ============================================================================
+namespace Math {
+// ==========================================================================
+/** @class BinomialCache
+ *  Bounded cache of choose_double and log_choose in all accuracy tiers,
+ *  keyed on (n,k,function), shared by any number of threads.
+ *
+ *  The table is split into shards of one cache line with four entries:
+ *  a lookup is one hash and one cache line. Each entry is guarded by its
+ *  own sequence counter, so neither reads nor writes take locks. A writer
+ *  that finds the entry busy skips the insertion. When the shard is full
+ *  the new value replaces one of its entries. The memory is fixed at
+ *  construction: the largest power of two of shards within the cap,
+ *  allocated aligned to the cache line with nothing on top.
+ *
+ *  A hit costs ~1 ns more than the standard tier within the table
+ *  (n<=67), so the cache pays off for the exact tier and for the large
+ *  (n,k) repeated over and over.
+ *
+ *  @code
+ *  static Math::BinomialCache cache(1 << 20); // 1 MiB
+ *  const double c = cache.choose_double(n, k, Math::exact());
+ *  const Math::BinomialCache::Counters s = Math::BinomialCache::counters();
+ *  @endcode
+ */
+class BinomialCache {
+public:
+  // ========================================================================
+  /// the hits and misses of the calling thread
+  struct Counters {
+    std::uint64_t hits;
+    std::uint64_t misses;
+  };
+  // ========================================================================
+public:
+  // ========================================================================
+  /// the cache within max_bytes, at least one shard of 64 bytes
+  explicit BinomialCache(const std::size_t max_bytes = 1u << 20);
+  ~BinomialCache();
+  BinomialCache(const BinomialCache &) = delete;
+  BinomialCache &operator=(const BinomialCache &) = delete;
+  // ========================================================================
+public:
+  // ========================================================================
+  /// C(n,k) as double, see Math::choose_double
+  double choose_double(const unsigned short n, const unsigned short k) {
+    return choose_double(n, k, standard());
+  }
+  /// C(n,k) as double in the Stirling tier, see Math::stirling
+  double choose_double(const unsigned short n, const unsigned short k,
+                       stirling);
+  /// C(n,k) as double in the default tier, see Math::standard
+  double choose_double(const unsigned short n, const unsigned short k,
+                       standard);
+  /// C(n,k) correctly rounded, see Math::exact
+  double choose_double(const unsigned short n, const unsigned short k, exact);
+  // ========================================================================
+  /// \f$ \log C^n_k \f$, see Math::log_choose
+  double log_choose(const unsigned short n, const unsigned short k) {
+    return log_choose(n, k, standard());
+  }
+  /// \f$ \log C^n_k \f$ in the Stirling tier, see Math::stirling
+  double log_choose(const unsigned short n, const unsigned short k, stirling);
+  /// \f$ \log C^n_k \f$ in the default tier, see Math::standard
+  double log_choose(const unsigned short n, const unsigned short k, standard);
+  /// \f$ \log C^n_k \f$ correctly rounded, see Math::exact
+  double log_choose(const unsigned short n, const unsigned short k, exact);
+  // ========================================================================
+public:
+  // ========================================================================
+  /// the number of entries
+  std::size_t capacity() const { return 4 * (m_mask + 1); }
+  /// the memory taken by the entries
+  std::size_t bytes() const { return 64 * (m_mask + 1); }
+  /// forget all entries, the concurrent lookups miss
+  void clear();
+  // ========================================================================
+public:
+  // ========================================================================
+  /// the counters of the calling thread, summed over all caches
+  static Counters counters();
+  /// reset the counters of the calling thread
+  static void reset_counters();
+  // ========================================================================
+private:
+  // ========================================================================
+  /// the cached functions
+  enum Function {
+    ChooseStirling,
+    ChooseStandard,
+    ChooseExact,
+    LogStirling,
+    LogStandard,
+    LogExact
+  };
+  /// the shard: one cache line
+  struct Shard;
+  // ========================================================================
+  /// the cached value of f(n,k)
+  template <class FUNCTOR>
+  double _get_(const Function f, const unsigned short n,
+               const unsigned short k, FUNCTOR compute);
+  // ========================================================================
+private:
+  // ========================================================================
+  /// the shards, aligned to the cache line
+  Shard *m_shards;
+  /// the number of shards minus one
+  std::size_t m_mask;
+  // ========================================================================
+};
+// ==========================================================================
+}
+#endif // LHCBMATH_CHOOSECACHE_H
+// ============================================================================
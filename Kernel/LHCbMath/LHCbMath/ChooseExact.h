@@ -0,0 +1,90 @@
+#ifndef LHCBMATH_CHOOSEEXACT_H
+#define LHCBMATH_CHOOSEEXACT_H 1
+// ============================================================================
+// Include files
+// ============================================================================
+// STD & STL
+// ============================================================================
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+// ============================================================================
+// local
+// ============================================================================
+#include "LHCbMath/Choose.h"
+// ============================================================================
+/** @file
+ *  Exact binomial coefficients of arbitrary size
+ */
+// ============================================================================
+namespace Math {
+// ==========================================================================
+/** @class BigUInt
+ *  Minimal unsigned integer of arbitrary size:
+ *  enough to build and compare reference values of binomial coefficients.
+ *  The limbs are stored little-endian without leading zeros.
+ */
+class BigUInt {
+public:
+  // ========================================================================
+  /// the limb
+  typedef std::uint64_t Limb;
+  // ========================================================================
+public:
+  // ========================================================================
+  /// construct from the unsigned integer
+  BigUInt(const UINT128 value = 0);
+  // ========================================================================
+public:
+  // ========================================================================
+  /// the limbs, little-endian
+  const std::vector<Limb> &limbs() const { return m_limbs; }
+  /// number of significant bits
+  std::size_t bits() const;
+  /// is it zero?
+  bool zero() const { return m_limbs.empty(); }
+  // ========================================================================
+public:
+  // ========================================================================
+  /// multiplication (Karatsuba for large numbers)
+  BigUInt operator*(const BigUInt &right) const;
+  /// multiplication by a limb
+  BigUInt &operator*=(const Limb right);
+  /// comparison
+  bool operator==(const BigUInt &right) const {
+    return m_limbs == right.m_limbs;
+  }
+  /// comparison
+  bool operator!=(const BigUInt &right) const { return !(*this == right); }
+  // ========================================================================
+public:
+  // ========================================================================
+  /// convert to double, correctly rounded (to nearest, ties to even)
+  double to_double() const;
+  /// decimal representation
+  std::string to_string() const;
+  // ========================================================================
+private:
+  // ========================================================================
+  /// the limbs, little-endian without leading zeros
+  std::vector<Limb> m_limbs;
+  // ========================================================================
+};
+// ==========================================================================
+/** calculate the exact binomial coefficient C(n,k) = n!/((n-k)!*k!)
+ *
+ *  The prime factorization of C(n,k) follows from the sieve and Legendre's
+ *  formula for the exponents. The prime powers are then multiplied in a
+ *  balanced product tree.
+ *
+ *  @code
+ *  const Math::BigUInt c = Math::choose_exact(60000, 30000);
+ *  std::cout << c.to_string() << std::endl;
+ *  @endcode
+ */
+BigUInt choose_exact(const unsigned short n, const unsigned short k);
+// ==========================================================================
+}
+#endif // LHCBMATH_CHOOSEEXACT_H
+// ============================================================================
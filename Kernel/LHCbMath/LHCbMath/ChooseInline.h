@@ -0,0 +1,547 @@
+#ifndef LHCBMATH_CHOOSEINLINE_H
+#define LHCBMATH_CHOOSEINLINE_H 1
+// ============================================================================
+// Include files
+// ============================================================================
+// STD & STL
+// ============================================================================
+#include <cmath>
+#include <cstdint>
+#include <limits>
+// ============================================================================
+// local
+// ============================================================================
+#include "LHCbMath/Choose.h"
+#include "LHCbMath/MathKernels.h"
+// ============================================================================
+/** @file
+ *  Inline binomial coefficients: opt-in inline versions of the
+ *  scalar functions of LHCbMath/Choose.h.
+ *
+ *  Math::Inline::choose, choose128, choose_double, log_choose, log_choose64,
+ *  log_factorial, gen_choose and choose_half give the same results as their
+ *  compiled counterparts in Math, bit for bit: the compiled functions are
+ *  thin wrappers around them. A call through this header is not an opaque
+ *  call into LHCbMathLib, so the compiler may inline it, propagate constant
+ *  arguments and vectorize the loop around it without LTO.
+ *
+ *  The constant tables (~80 KiB) are defined once in LHCbMathLib, so the
+ *  users still link it: their contents are not known to the compiler.
+ *  The table of log(n!) (512 KiB) is built on the first call needing it.
+ *  The batch, row, accuracy-tier, multinomial and cursor functions exist
+ *  in the compiled library only.
+ *
+ *  @code
+ *  #include "LHCbMath/ChooseInline.h"
+ *  double s = 0;
+ *  for (unsigned short n = 10; n < 1000; ++n) {
+ *    s += Math::Inline::log_choose(n, 5); // inlined with constant k
+ *  }
+ *  @endcode
+ */
+// ============================================================================
+namespace Math {
+// ========================================================================
+namespace Inline {
+// ======================================================================
+/// the implementation, shared with the compiled library
+namespace detail {
+// ====================================================================
+/// the largest unsigned long long, the saturated result
+const unsigned long long s_ullmax =
+    std::numeric_limits<unsigned long long>::max();
+// ====================================================================
+/** @struct PascalTable
+ *  Compile-time table of binomial coefficients C(n,k) for n<=NMAX,
+ *  where NMAX is the largest n for which all C(n,k) fit into TYPE.
+ *  Only k<=n/2 is stored, the rest follows from C(n,k)=C(n,n-k).
+ *  The table also keeps the "frontier": for each k<=NMAX/2 the largest n
+ *  for which C(n,k) still fits into TYPE.
+ *  For k>NMAX/2 C(n,k) never fits.
+ */
+template <class TYPE, unsigned short NMAX> struct PascalTable {
+  // ==================================================================
+  /// the largest n for which all C(n,k) fit into TYPE
+  static constexpr unsigned short nmax = NMAX;
+  /// the largest k for which some C(n,k) fit into TYPE
+  static constexpr unsigned short kmax = NMAX / 2;
+  static_assert(1 == NMAX % 2, "PascalTable: NMAX must be odd");
+  // ==================================================================
+  /// position of C(n,k) in the triangular table, k<=n/2
+  static constexpr unsigned int index(const unsigned short n,
+                                      const unsigned short k) {
+    return (n / 2) * (n / 2 + 1) + (n % 2) * (n / 2 + 1) + k;
+  }
+  /// number of stored coefficients, i.e. index(nmax+1,0) for odd nmax
+  static constexpr unsigned int size = (kmax + 1) * (kmax + 2);
+  // ==================================================================
+  constexpr PascalTable() : m_table{}, m_frontier{} {
+    for (unsigned short n = 0; n <= nmax; ++n) {
+      m_table[index(n, 0)] = 1;
+      for (unsigned short k = 1; 2 * k <= n; ++k) {
+        // C(n,k) = C(n-1,k-1) + C(n-1,k), the latter possibly mirrored
+        const unsigned short k2 = 2 * k < n ? k : n - 1 - k;
+        m_table[index(n, k)] =
+            m_table[index(n - 1, k - 1)] + m_table[index(n - 1, k2)];
+      }
+    }
+    //
+    const TYPE tmax = ~TYPE(0);
+    m_frontier[0] = std::numeric_limits<unsigned short>::max();
+    m_frontier[1] = std::numeric_limits<unsigned short>::max();
+    for (unsigned short k = 2; k <= kmax; ++k) {
+      // saturation of Constexpr::choose is monotonic in n: bisect
+      unsigned short lo = nmax; // C(nmax,k) fits
+      unsigned short hi = std::numeric_limits<unsigned short>::max();
+      if (tmax != Math::Constexpr::choose<TYPE>(hi, k)) {
+        lo = hi;
+      }
+      while (lo + 1 < hi) {
+        const unsigned short mid = lo + (hi - lo) / 2;
+        if (tmax != Math::Constexpr::choose<TYPE>(mid, k)) {
+          lo = mid;
+        } else {
+          hi = mid;
+        }
+      }
+      m_frontier[k] = lo;
+    }
+  }
+  // ==================================================================
+  /// get C(n,k) for n<=nmax and k<=n/2
+  constexpr TYPE operator()(const unsigned short n,
+                            const unsigned short k) const {
+    return m_table[index(n, k)];
+  }
+  /// does C(n,k) fit into TYPE? (k<=n/2)
+  constexpr bool fits(const unsigned short n, const unsigned short k) const {
+    return k <= kmax && n <= m_frontier[k];
+  }
+  // ==================================================================
+private:
+  // ==================================================================
+  /// the triangular table
+  TYPE m_table[size];
+  /// the largest n for which C(n,k) fits into TYPE
+  unsigned short m_frontier[kmax + 1];
+  // ==================================================================
+};
+// ====================================================================
+/// the table for unsigned long long
+typedef PascalTable<unsigned long long, 67> Pascal;
+/// the table for unsigned 128-bit integers
+typedef PascalTable<Math::UINT128, 131> Pascal128;
+// ====================================================================
+/** @struct Reciprocals
+ *  Compile-time table to replace the division by d<=DMAX with
+ *  a shift and a multiplication: d = 2^shift * odd, and inverse is the
+ *  multiplicative inverse of odd modulo 2^N for N-bit TYPE.
+ *  It is exact when the dividend is a multiple of d.
+ */
+template <class TYPE, unsigned short DMAX> struct Reciprocals {
+  // ==================================================================
+  constexpr Reciprocals() : m_inverse{}, m_shift{} {
+    for (unsigned short d = 1; d <= DMAX; ++d) {
+      unsigned short odd = d;
+      while (0 == odd % 2) {
+        odd /= 2;
+        ++m_shift[d];
+      }
+      // Newton iterations: each doubles the number of correct bits
+      TYPE x = odd; // correct to 3 bits
+      for (unsigned short i = 0; i < 6; ++i) {
+        x *= 2 - odd * x;
+      }
+      m_inverse[d] = x;
+    }
+  }
+  // ==================================================================
+  /// exact division of a*m by d, for a*m multiple of d
+  TYPE divide(TYPE a, unsigned short m, const unsigned short d) const {
+    // remove 2^shift from a and m first, the rest may wrap around
+    unsigned short s = m_shift[d];
+    for (; 0 < s && 0 == a % 2; --s) {
+      a /= 2;
+    }
+    return a * (m >> s) * m_inverse[d];
+  }
+  /// exact division of a multiple of d by d, a/2^shift must fit into TYPE
+  TYPE divide(const Math::UINT128 a, const unsigned short d) const {
+    return (TYPE)(a >> m_shift[d]) * m_inverse[d];
+  }
+  // ==================================================================
+private:
+  // ==================================================================
+  /// inverse of the odd part of d modulo 2^N
+  TYPE m_inverse[DMAX + 1];
+  /// power of two in d
+  unsigned short m_shift[DMAX + 1];
+  // ==================================================================
+};
+// ====================================================================
+/** @struct ChooseTables
+ *  The constant tables. They are evaluated once, at the compile time of
+ *  src/ChooseTables.cpp, and defined there: the ~1 s of the constexpr
+ *  evaluation is not repeated by each file including this header.
+ */
+struct ChooseTables {
+  // ==================================================================
+  /// the tables of binomial coefficients, aligned to the cache line
+  alignas(64) static const Pascal pascal;
+  alignas(64) static const Pascal128 pascal128;
+  /// the tables of reciprocals
+  static const Reciprocals<unsigned long long, Pascal::kmax> reciprocals;
+  static const Reciprocals<Math::UINT128, Pascal128::kmax> reciprocals128;
+  /// delta(x) = log(x!) - (x+1/2)*log(x) + x - log(2*pi)/2 for 0<x<32
+  alignas(64) static constexpr double stirling_delta[32] = {
+      0,                     0.08106146679532726,   0.0413406959554093,
+      0.02767792568499834,   0.020790672103765093,  0.016644691189821193,
+      0.013876128823070748,  0.01189670994589177,   0.010411265261972096,
+      0.009255462182712733,  0.00833056343336287,   0.007573675487951841,
+      0.00694284010720953,   0.006408994188004207,  0.0059513701127588475,
+      0.005554733551962801,  0.0052076559196096404, 0.004901395948434738,
+      0.004629153749334028,  0.004385560249232324,  0.004166319691996922,
+      0.00396795421864086,   0.0037876180684444346, 0.0036229602246830948,
+      0.003472021382978767,  0.003333155636728093,  0.003204970228055038,
+      0.0030862786826087773, 0.002976063983550409,  0.0028734493623524663,
+      0.0027776749297526936, 0.002688078828531143};
+  // ==================================================================
+};
+// ====================================================================
+/** calculate C(n,k) without divisions, k<=n/2 and Pascal::fits(n,k)
+ *  The intermediate r = C(n,d-1) * (n-d+1) is a multiple of d.
+ *  The result is identical to Math::Constexpr::choose(n,k)
+ */
+inline unsigned long long _choose_exact_(unsigned short n,
+                                         const unsigned short k) {
+  unsigned long long r = 1;
+  for (unsigned short d = 1; d <= k; ++d, --n) {
+    r = ChooseTables::reciprocals.divide((Math::UINT128)r * n, d);
+  }
+  return r;
+}
+// ====================================================================
+/** calculate C(n,k) in 128 bits without divisions,
+ *  k<=n/2 and Pascal128::fits(n,k)
+ */
+inline Math::UINT128 _choose128_exact_(unsigned short n,
+                                       const unsigned short k) {
+  Math::UINT128 r = 1;
+  for (unsigned short d = 1; d <= k; ++d, --n) {
+    r = ChooseTables::reciprocals128.divide(r, n, d);
+  }
+  return r;
+}
+// ====================================================================
+/** @struct LogFactorials
+ *  The table of log(n!) for all unsigned short n (512 KiB).
+ *  The sum is accumulated in double-double and rounded once to double.
+ */
+struct LogFactorials {
+  // ==================================================================
+  LogFactorials() {
+    Math::Kernels::DD s = {0, 0};
+    m_table[0] = 0;
+    for (unsigned int n = 1; n < size; ++n) {
+      s = s + Math::Kernels::log_dd(n);
+      m_table[n] = s.hi;
+    }
+  }
+  // ==================================================================
+  /// get log(n!)
+  double operator()(const unsigned short n) const { return m_table[n]; }
+  // ==================================================================
+private:
+  // ==================================================================
+  static const unsigned int size =
+      1u + std::numeric_limits<unsigned short>::max();
+  /// the table
+  double m_table[size];
+  // ==================================================================
+};
+// ====================================================================
+/// get the table of log(n!), it is built on the first call (thread-safe)
+inline const LogFactorials &_log_factorials_() {
+  static const LogFactorials s_table{};
+  return s_table;
+}
+// ====================================================================
+/// C(n,k) with saturation in 128 bits, see Math::choose128
+inline Math::UINT128 _choose128_(const unsigned short n,
+                                 const unsigned short k) {
+  //
+  if (k > n) {
+    return 0;
+  }
+  //
+  const unsigned short k1 = 2 * k < n ? k : n - k;
+  if (n <= Pascal128::nmax) {
+    return ChooseTables::pascal128(n, k1);
+  } else if (!ChooseTables::pascal128.fits(n, k1)) {
+    return ~Math::UINT128(0);
+  }
+  //
+  return _choose128_exact_(n, k1);
+}
+// ====================================================================
+/// C(n,k) with saturation, see Math::choose
+inline unsigned long long _choose_ull_(const unsigned short n,
+                                       const unsigned short k) {
+  //
+  if (k > n) {
+    return 0;
+  }
+  //
+  const unsigned short k1 = 2 * k < n ? k : n - k;
+  if (n <= Pascal::nmax) {
+    return ChooseTables::pascal(n, k1);
+  } else if (!ChooseTables::pascal.fits(n, k1)) {
+    return s_ullmax;
+  }
+  //
+  return _choose_exact_(n, k1);
+}
+// ====================================================================
+/// C(n,k) as double, see Math::choose_double
+inline double _choose_double_(const unsigned short n, const unsigned short k) {
+  //
+  if (k > n) {
+    return 0;
+  } else if (0 == k || n == k) {
+    return 1;
+  }
+  //
+  const unsigned short k1 = 2 * k < n ? k : n - k;
+  if (n <= Pascal::nmax) {
+    return ChooseTables::pascal(n, k1);
+  } else if (ChooseTables::pascal.fits(n, k1)) {
+    return _choose_exact_(n, k1);
+  }
+  //
+  const LogFactorials &lf = _log_factorials_();
+  return Math::Kernels::exp(lf(n) - lf(n - k) - lf(k));
+}
+// ====================================================================
+/// log C(n,k), see Math::log_choose
+inline double _log_choose_(const unsigned short n, const unsigned short k) {
+  if (0 == k || k >= n) {
+    return 0;
+  } //
+  const unsigned short k1 = 2 * k < n ? k : n - k;
+  if (n <= Pascal::nmax) {
+    return Math::Kernels::log(ChooseTables::pascal(n, k1));
+  } else if (ChooseTables::pascal.fits(n, k1)) {
+    return Math::Kernels::log(_choose_exact_(n, k1));
+  }
+  //
+  const LogFactorials &lf = _log_factorials_();
+  return lf(n) - lf(n - k) - lf(k);
+}
+// ====================================================================
+/** k above which C(a,k) is taken from the gamma-function ratio.
+ *  The product is correctly rounded and the ratio is within 3 ULP;
+ *  the ratio costs as much as ~60 steps of the product.
+ */
+const unsigned short s_gen_choose_kmax = 64;
+/** |a| from which C(a,k) overflows for all k>s_gen_choose_kmax (and the
+ *  float threshold 48): C(2^44,49) > 2^1900. Beyond it the rounding
+ *  errors of the log-gamma functions, ~a*log(a), swamp log|C(a,k)|.
+ */
+const double s_gen_choose_amax = 17592186044416.0; // 2^44
+// ====================================================================
+/// C(a,k) for |a|>=s_gen_choose_amax and k>s_gen_choose_kmax: +-inf
+inline double _gen_choose_inf_(const double a, const unsigned short k) {
+  const double inf = std::numeric_limits<double>::infinity();
+  return a < 0 && 1 == k % 2 ? -inf : inf;
+}
+// ====================================================================
+/** r*2^-s with |r.hi| in [1/2,1) and e += s, if |r.hi| is outside of
+ *  [2^-400,2^400]. The recurrences of C(a,k) keep C = r*2^e this way,
+ *  so that no step overflows or underflows before the final ldexp.
+ *  Double-double scales exactly by powers of two: the results are those
+ *  of the unscaled recurrence wherever it stays finite and normal.
+ */
+LHCBMATH_KERNEL Math::Kernels::DD
+_gen_choose_scaled_(const Math::Kernels::DD &r, int &e) {
+  const double big = 2.5822498780869086e+120; // 2^400
+  const double x = std::abs(r.hi);
+  if ((1 / big <= x && x <= big) || 0 == x || !Math::Kernels::finite(x)) {
+    return r;
+  }
+  int s = 0;
+  std::frexp(r.hi, &s);
+  e += s;
+  const Math::Kernels::DD t = {std::ldexp(r.hi, -s), std::ldexp(r.lo, -s)};
+  return t;
+}
+/// one step C(a,j+1) = C(a,j)*(a-j)/(j+1) with C = r*2^e, a-j exactly
+LHCBMATH_KERNEL Math::Kernels::DD
+_gen_choose_step_(const Math::Kernels::DD &r, int &e,
+                  const Math::Kernels::DD &a, const unsigned short j) {
+  // a-j is exact; inf stays inf
+  const Math::Kernels::DD b =
+      Math::Kernels::finite(a.hi) ? _gen_choose_scaled_(a - double(j), e) : a;
+  return _gen_choose_scaled_(r, e) * b / (j + 1);
+}
+// ====================================================================
+/// C(a,k) = r*2^e as the product of (a-j)/(j+1), see _gen_choose_step_
+inline Math::Kernels::DD _gen_choose_product_(const Math::Kernels::DD &a,
+                                              const unsigned short k,
+                                              int &e) {
+  Math::Kernels::DD r = {1, 0};
+  e = 0;
+  for (unsigned short j = 0; j < k; ++j) {
+    r = _gen_choose_step_(r, e, a, j);
+  }
+  return r;
+}
+// ====================================================================
+/** log|C(a,k)| from Gamma(a+1)/(Gamma(k+1)*Gamma(a-k+1)) in O(1), with
+ *  the log-gamma functions in double-double; the sign of C(a,k) goes to
+ *  sign (0 if C(a,k)=0). The negative arguments are moved to the positive
+ *  ones by the reflection formulae:
+ *  - a<0      : C(a,k) = (-1)^k C(k-a-1,k)
+ *  - 0<=a<k-1 : 1/Gamma(a-k+1) = (-1)^(k-1) sin(pi*a) Gamma(k-a)/pi
+ */
+inline Math::Kernels::DD _gen_choose_log_(const Math::Kernels::DD &a,
+                                          const unsigned short k, int &sign) {
+  using Math::Kernels::DD;
+  using Math::Kernels::lgamma_dd;
+  const DD lk = lgamma_dd(Math::Kernels::two_sum(k, 1));
+  const DD b = a - double(k - 1);
+  if (0 < b.hi) {
+    // all arguments are positive
+    sign = 1;
+    return lgamma_dd(a + 1.0) - lk - lgamma_dd(b);
+  } else if (a.hi < 0) {
+    // C(k-a-1,k)
+    sign = 0 == k % 2 ? 1 : -1;
+    return lgamma_dd(-a + double(k)) - lk - lgamma_dd(-a);
+  }
+  // 0<=a<=k-1: zero for integer a, sin(pi*a) = (-1)^m sin(pi*(a-m))
+  const double m = std::nearbyint(a.hi);
+  const DD f = a - m;
+  if (0 == f.hi) {
+    sign = 0;
+    return f;
+  }
+  const DD lpi = {1.1447298858494002, 1.0265951162707826e-17}; // log(pi)
+  const DD sf = Math::Kernels::sinpi_dd(f);
+  sign = (k - 1 + int(m) + (f.hi < 0)) % 2 ? -1 : 1;
+  return lgamma_dd(a + 1.0) + lgamma_dd(-a + double(k)) - lk +
+         Math::Kernels::log_dd(sf.hi < 0 ? -sf : sf) - lpi;
+}
+// ====================================================================
+/// C(a,k) for real a, see Math::gen_choose
+inline double _gen_choose_(const double a, const unsigned short k) {
+  const Math::Kernels::DD ad = {a, 0};
+  if (k <= s_gen_choose_kmax) {
+    int e = 0;
+    const double r = _gen_choose_product_(ad, k, e).hi;
+    return 0 == e ? r : std::ldexp(r, e);
+  } else if (s_gen_choose_amax <= std::abs(a)) {
+    return _gen_choose_inf_(a, k);
+  }
+  int sign = 0;
+  const Math::Kernels::DD l = _gen_choose_log_(ad, k, sign);
+  return 0 == sign ? 0 : sign * Math::Kernels::exp(l.hi) * (1 + l.lo);
+}
+// ====================================================================
+/** delta(x) from the table for x<32, from the asymptotic series beyond:
+ *  its first omitted term 1/(1188*x^9) is below 3e-17
+ */
+inline double _stirling_delta_(const std::uint64_t x) {
+  if (x < 32) {
+    return ChooseTables::stirling_delta[x];
+  }
+  const double r = 1 / double(x);
+  const double r2 = r * r;
+  return r * (1.0 / 12 - r2 * (1.0 / 360 - r2 * (1.0 / 1260 - r2 / 1680)));
+}
+// ====================================================================
+/** log C(n,k) for 64-bit n, with j = min(k,n-k), m = n-j and t = j/n:
+ *  log C = j*log(n/j) - m*log(1-t) - (log(1-t) + log(j))/2 - log(2*pi)/2
+ *        + delta(n) - delta(j) - delta(m)
+ *  The large terms are positive: unlike log(n!) - log(j!) - log(m!) there
+ *  is no cancellation, the result keeps its relative precision for any n
+ */
+inline double _log_choose64_(const std::uint64_t n, const std::uint64_t k) {
+  if (0 == k || k >= n) {
+    return 0;
+  }
+  const std::uint64_t j = k < n - k ? k : n - k;
+  const std::uint64_t m = n - j;
+  const double x = double(n);
+  const double z = double(j);
+  const double l1 = std::log1p(-z / x);
+  return z * Math::Kernels::log(x / z) - double(m) * l1 -
+         0.5 * (l1 + Math::Kernels::log(z)) - 0.91893853320467278 +
+         (_stirling_delta_(n) - _stirling_delta_(j) - _stirling_delta_(m));
+}
+// ====================================================================
+}
+// ======================================================================
+/// C(n,k) with saturation, see Math::choose
+inline unsigned long long choose(const unsigned short n,
+                                 const unsigned short k) {
+  return detail::_choose_ull_(n, k);
+}
+// ======================================================================
+/// C(n,k) with saturation in 128 bits, see Math::choose128
+inline Math::UINT128 choose128(const unsigned short n,
+                               const unsigned short k) {
+  return detail::_choose128_(n, k);
+}
+// ======================================================================
+/// C(n,k) as double, see Math::choose_double
+inline double choose_double(const unsigned short n, const unsigned short k) {
+  return detail::_choose_double_(n, k);
+}
+// ======================================================================
+/// log C(n,k), see Math::log_choose
+inline double log_choose(const unsigned short n, const unsigned short k) {
+  return detail::_log_choose_(n, k);
+}
+// ======================================================================
+/// log C(n,k) for 64-bit n, see Math::log_choose64
+inline double log_choose64(const std::uint64_t n, const std::uint64_t k) {
+  return detail::_log_choose64_(n, k);
+}
+// ======================================================================
+/// log(n!), see Math::log_factorial
+inline double log_factorial(const unsigned short n) {
+  return detail::_log_factorials_()(n);
+}
+// ======================================================================
+/// C(a,k) for real a, see Math::gen_choose
+inline double gen_choose(const double a, const unsigned short k) {
+  if (0 == k) {
+    return 1;
+  } else if (1 == k) {
+    return a;
+  }
+  return 0 == a ? 0 : detail::_gen_choose_(a, k);
+}
+// ======================================================================
+/// C(n/2,k), see Math::choose_half
+inline double choose_half(const int n, const unsigned short k) {
+  if (0 == k) {
+    return 1;
+  } else if (0 < n && 0 == n % 2 &&
+             n / 2 <= std::numeric_limits<unsigned short>::max()) {
+    return choose_double(n / 2, k);
+  } else if (1 == k) {
+    return 0.5 * n;
+  } else if (0 == n) {
+    return 0;
+  }
+  // n/2 is exact in double
+  return gen_choose(0.5 * n, k);
+}
+// ======================================================================
+}
+// ========================================================================
+}
+// ============================================================================
+#endif // LHCBMATH_CHOOSEINLINE_H
+// ============================================================================
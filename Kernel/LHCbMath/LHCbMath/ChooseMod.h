@@ -0,0 +1,90 @@
+#ifndef LHCBMATH_CHOOSEMOD_H
+#define LHCBMATH_CHOOSEMOD_H 1
+// ============================================================================
+// Include files
+// ============================================================================
+// STD & STL
+// ============================================================================
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+// ============================================================================
+/** @file
+ *  Binomial coefficients modulo a prime
+ */
+// ============================================================================
+namespace Math {
+// ==========================================================================
+/** @class ChooseMod
+ *  Binomial coefficients C(n,k) modulo the prime p.
+ *
+ *  The tables of factorials and inverse factorials modulo p are built once,
+ *  they hold all p residues: 8 bytes per residue, 32 MiB for the largest
+ *  prime s_pmax. A query then costs O(1) for n<p and O(log_p n) table
+ *  lookups via Lucas' theorem for n>=p.
+ *
+ *  @code
+ *  const Math::ChooseMod cm(1000003);
+ *  const std::uint32_t h = cm(123456789, 4321);
+ *  @endcode
+ */
+class ChooseMod {
+public:
+  // ========================================================================
+  /// the largest prime below 2^22: the tables hold p entries each
+  static const std::uint32_t s_pmax = 4194301;
+  // ========================================================================
+public:
+  // ========================================================================
+  /** constructor
+   *  @param p the prime modulus, 2<=p<=s_pmax (primality is not checked)
+   *  @exception std::invalid_argument for p outside of [2,s_pmax]
+   */
+  explicit ChooseMod(const std::uint32_t p);
+  // ========================================================================
+public:
+  // ========================================================================
+  /// C(n,k) mod p
+  std::uint32_t operator()(const std::uint64_t n, const std::uint64_t k) const;
+  /// out[i] = C(n[i],k[i]) mod p for i<size
+  void operator()(const std::uint64_t *n, const std::uint64_t *k,
+                  std::uint32_t *out, const std::size_t size) const;
+  /// the prime
+  std::uint32_t prime() const { return m_p; }
+  // ========================================================================
+private:
+  // ========================================================================
+  /// C(n,k) mod p for n<p
+  std::uint32_t small(const std::uint32_t n, const std::uint32_t k) const;
+  // ========================================================================
+private:
+  // ========================================================================
+  /// the prime
+  std::uint32_t m_p;
+  /// n! mod p
+  std::vector<std::uint32_t> m_fact;
+  /// 1/n! mod p
+  std::vector<std::uint32_t> m_inv;
+  // ========================================================================
+};
+// ==========================================================================
+/** calculate the binomial coefficient C(n,k) modulo the prime p
+ *  The tables of the recently used primes are shared by all threads
+ *  within 64 MiB, the least recently used ones are released first.
+ *  Each call takes a lock: keep a Math::ChooseMod in the tight loops or
+ *  to cycle through more primes.
+ *  @see Math::ChooseMod
+ */
+std::uint32_t choose_mod(const std::uint64_t n, const std::uint64_t k,
+                         const std::uint32_t p);
+// ==========================================================================
+/** calculate the binomial coefficients C(n[i],k[i]) modulo the prime p
+ *  @see Math::ChooseMod
+ */
+void choose_mod(const std::uint64_t *n, const std::uint64_t *k,
+                std::uint32_t *out, const std::size_t size,
+                const std::uint32_t p);
+// ==========================================================================
+}
+#endif // LHCBMATH_CHOOSEMOD_H
+// ============================================================================
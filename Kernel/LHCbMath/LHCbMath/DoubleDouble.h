@@ -0,0 +1,113 @@
+#ifndef LHCBMATH_DOUBLEDOUBLE_H
+#define LHCBMATH_DOUBLEDOUBLE_H 1
+// ============================================================================
+/** @file
+ *  The double-double number Math::Kernels::DD and its constexpr
+ *  error-free transformations, without the kernels of MathKernels.h,
+ *  so that Math::Constexpr in LHCbMath/Choose.h can use them.
+ *
+ *  They are exact only if a*b+c is not contracted into FMA: clang is told
+ *  so within each function, the setting of the including file is left
+ *  alone. GCC code compiled for FMA targets needs -ffp-contract=off,
+ *  see LHCbMath/MathKernels.h.
+ */
+// ============================================================================
+#if defined(__GNUC__)
+#define LHCBMATH_DD_INLINE __attribute__((always_inline))
+#else
+#define LHCBMATH_DD_INLINE
+#endif
+#if defined(__clang__)
+#define LHCBMATH_DD_EXACT _Pragma("STDC FP_CONTRACT OFF")
+#else
+#define LHCBMATH_DD_EXACT
+#endif
+// ============================================================================
+namespace Math {
+// ==========================================================================
+namespace Kernels {
+// ========================================================================
+/** @struct DD
+ *  double-double: the unevaluated sum hi+lo with |lo|<=ulp(hi)/2,
+ *  about 106 bits of precision with the exponent range of double.
+ *  The operations follow the QD library (Hida, Li and Bailey).
+ */
+struct DD {
+  /// the leading part, the value rounded to double
+  double hi;
+  /// the rest
+  double lo;
+};
+// ========================================================================
+/// x is neither inf nor NaN, also in constant expressions
+LHCBMATH_DD_INLINE constexpr bool finite(const double x) { return x - x == 0; }
+// ========================================================================
+/// a+b = s.hi+s.lo exactly (Knuth)
+LHCBMATH_DD_INLINE constexpr DD two_sum(const double a, const double b) {
+  LHCBMATH_DD_EXACT
+  const double s = a + b;
+  const double bb = s - a;
+  const DD r = {s, (a - (s - bb)) + (b - bb)};
+  return r;
+}
+/// a+b = s.hi+s.lo exactly for |a|>=|b| (Dekker)
+LHCBMATH_DD_INLINE constexpr DD fast_two_sum(const double a, const double b) {
+  LHCBMATH_DD_EXACT
+  const double s = a + b;
+  const DD r = {s, b - (s - a)};
+  return r;
+}
+/** a = hi+lo with 26-bit halves (Dekker's split); a is scaled by 2^-28
+ *  above 2^996, so that (2^27+1)*a does not overflow
+ */
+LHCBMATH_DD_INLINE constexpr DD split(const double a) {
+  LHCBMATH_DD_EXACT
+  // 2^996, 2^-28 and 2^28
+  const double big = 6.6969287949141707e+299;
+  if (a < -big || big < a) {
+    const double as = a * 3.7252902984619140625e-09;
+    const double c = 134217729.0 * as; // 2^27+1
+    const double hi = (c - (c - as)) * 268435456.0;
+    const DD r = {hi, a - hi};
+    return r;
+  }
+  const double c = 134217729.0 * a;
+  const double hi = c - (c - a);
+  const DD r = {hi, a - hi};
+  return r;
+}
+/// the rounding error a*b-p of p = a*b for |p|<=2^1000 (Dekker)
+LHCBMATH_DD_INLINE constexpr double dekker_error(const double a,
+                                                 const double b,
+                                                 const double p) {
+  LHCBMATH_DD_EXACT
+  const DD x = split(a);
+  const DD y = split(b);
+  return ((x.hi * y.hi - p) + x.hi * y.lo + x.lo * y.hi) + x.lo * y.lo;
+}
+/** a*b = p.hi+p.lo exactly by Dekker's split, also in constant
+ *  expressions. The error is meaningless if a*b is not finite.
+ */
+LHCBMATH_DD_INLINE constexpr DD two_prod_dekker(const double a,
+                                                const double b) {
+  LHCBMATH_DD_EXACT
+  const double p = a * b;
+  // 2^1000 and 2^28: just below the largest double hi*hi of the split
+  // may overflow, then a*2^-28 is normal and the error scales exactly
+  const double big = 1.0715086071862673e+301;
+  const double s = 268435456.0;
+  if (p < -big || big < p) {
+    const DD r = {p, finite(p) ? dekker_error(a / s, b, p / s) * s : 0};
+    return r;
+  }
+  const DD r = {p, dekker_error(a, b, p)};
+  return r;
+}
+// ========================================================================
+}
+// ==========================================================================
+}
+#undef LHCBMATH_DD_EXACT
+#undef LHCBMATH_DD_INLINE
+#endif // LHCBMATH_DOUBLEDOUBLE_H
+// ============================================================================
@@ -0,0 +1,21 @@
+#ifndef LHCBMATH_EXTENDEDTYPES_H
+#define LHCBMATH_EXTENDEDTYPES_H 1
+// ============================================================================
+/** @file
+ *  The extended arithmetic types of GCC and clang, defined once for all
+ *  LHCbMath headers
+ */
+// ============================================================================
+namespace Math {
+// ==========================================================================
+/// unsigned 128-bit integer (GCC and clang extension)
+__extension__ typedef unsigned __int128 UINT128;
+#if defined(__SIZEOF_FLOAT128__)
+#define LHCBMATH_FLOAT128 1
+/// IEEE quadruple precision (GCC and clang extension, x86_64)
+__extension__ typedef __float128 FLOAT128;
+#endif
+// ==========================================================================
+}
+#endif // LHCBMATH_EXTENDEDTYPES_H
+// ============================================================================
@@ -0,0 +1,436 @@
+#ifndef LHCBMATH_MATHKERNELS_H
+#define LHCBMATH_MATHKERNELS_H 1
+// ============================================================================
+// Include files
+// ============================================================================
+// STD & STL
+// ============================================================================
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+// ============================================================================
+// local
+// ============================================================================
+#include "LHCbMath/DoubleDouble.h"
+#include "LHCbMath/Unroll.h"
+// ============================================================================
+/** @file
+ *  Internal, reentrant elementary functions for double.
+ *
+ *  Unlike libm they keep no global state (no errno, no signgam) and have
+ *  no branches, so that loops calling them are vectorized by the compiler.
+ *  Functions marked with LHCBMATH_TARGET_CLONES get AVX2 and AVX-512
+ *  versions chosen at load time.
+ *
+ *  The special cases are handled by arithmetic, not by selects:
+ *  the compiler turns selects back into branches and then refuses to
+ *  vectorize floating point operations that may trap.
+ *
+ *  Maximal errors measured against the correctly rounded values:
+ *  - log    : 1 ULP
+ *  - log2   : 1 ULP
+ *  - exp    : 1 ULP (also in the subnormal range)
+ *  - lgamma : 3 ULP for x>=10, absolute error below 1e-14 for 0<x<10
+ *
+ *  The algorithms of log and exp follow fdlibm.
+ *
+ *  Math::Kernels::DD (LHCbMath/DoubleDouble.h) is a double-double number
+ *  for the accumulations that need more than double precision. Its
+ *  error-free transformations are exact with and without FMA, so the
+ *  results are identical on all targets as long as the compiler does not
+ *  contract a*b+c on its own.
+ *  Clang (the default of clang>=14 is to contract) is told so by the
+ *  STDC FP_CONTRACT pragma over this header, unless -ffp-contract=fast.
+ *  GCC contracts C++ by default and decides per function after inlining:
+ *  the clones of LHCBMATH_TARGET_CLONES turn it off, other code compiled
+ *  for FMA targets (-march=haswell, -mfma) needs -ffp-contract=off.
+ *  Internal to LHCbMath: installed only for LHCbMath/ChooseInline.h.
+ */
+// ============================================================================
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) &&       \
+    defined(__ELF__)
+// the cheap cost model: the default one of -O2 rejects the kernels;
+// no contraction: the results do not depend on the clone chosen
+#define LHCBMATH_TARGET_CLONES                                                 \
+  __attribute__((                                                              \
+      target_clones("arch=skylake-avx512", "arch=haswell", "default"),     \
+      optimize("tree-vectorize", "vect-cost-model=cheap",                   \
+               "fp-contract=off")))
+#else
+#define LHCBMATH_TARGET_CLONES
+#endif
+// the clones do not inline the usual inline functions
+#if defined(__GNUC__)
+#define LHCBMATH_KERNEL inline __attribute__((always_inline))
+#else
+#define LHCBMATH_KERNEL inline
+#endif
+// no contraction of a*b+c into FMA up to the end of the header
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+// ============================================================================
+namespace Math {
+// ==========================================================================
+namespace Kernels {
+// ========================================================================
+/// reinterpret the bits of double
+LHCBMATH_KERNEL std::uint64_t _bits_(const double x) {
+  std::uint64_t b;
+  std::memcpy(&b, &x, sizeof(b));
+  return b;
+}
+/// reinterpret the bits as double
+LHCBMATH_KERNEL double _double_(const std::uint64_t b) {
+  double x;
+  std::memcpy(&x, &b, sizeof(x));
+  return x;
+}
+// ========================================================================
+/// the bits of some special values
+const std::uint64_t s_one = 0x3ff0000000000000ULL;
+const std::uint64_t s_inf = 0x7ff0000000000000ULL;
+const std::uint64_t s_nan = 0x7ff8000000000000ULL;
+const std::uint64_t s_sign = 0x8000000000000000ULL;
+// ========================================================================
+/// the shifter 1.5*2^52: its last bits hold integers up to 2^51
+const double s_shifter = 6755399441055744.0;
+/// convert |k|<2^51 to double without the conversion instruction
+LHCBMATH_KERNEL double _int_to_double_(const std::int64_t k) {
+  return _double_(_bits_(s_shifter) + k) - s_shifter;
+}
+// ========================================================================
+/// log(2), split so that k*s_ln2_hi is exact for |k|<2^11
+const double s_ln2_hi = 6.93147180369123816490e-01;
+const double s_ln2_lo = 1.90821492927058770002e-10;
+/// 1/log(2)
+const double s_inv_ln2 = 1.44269504088896338700e+00;
+// ========================================================================
+/// log(1+f) for 1+f in [sqrt(1/2),sqrt(2)), without the final addition of f
+LHCBMATH_KERNEL double _log_reduced_(const double f, double &hfsq) {
+  const double s = f / (2.0 + f);
+  const double z = s * s;
+  const double w = z * z;
+  const double t1 = w * (3.999999999940941908e-01 +
+                         w * (2.222219843214978396e-01 +
+                              w * 1.531383769920937332e-01));
+  const double t2 = z * (6.666666666666735130e-01 +
+                         w * (2.857142874366239149e-01 +
+                              w * (1.818357216161805012e-01 +
+                                   w * 1.479819860511658591e-01)));
+  hfsq = 0.5 * f * f;
+  return s * (hfsq + t1 + t2);
+}
+// ========================================================================
+/** split x>0 into 2^e*(1+f) with 1+f in [sqrt(1/2),sqrt(2)),
+ *  subnormal x are scaled first.
+ *  For any other x both e and f are finite, but meaningless.
+ */
+LHCBMATH_KERNEL double _frexp_(const double x, double &e) {
+  // multiply by 2^54 for x<1 (normalizes the subnormal x) and by 1/2
+  // otherwise, with the sign bit of b-1 as the flag: a select would be
+  // optimized into a branch with a multiplication on each side
+  const std::uint64_t small = (_bits_(x) - s_one) >> 63;
+  const std::uint64_t b = _bits_(
+      x * _double_(0x3fe0000000000000ULL + small * 0x0370000000000000ULL));
+  // the bits of sqrt(1/2)
+  const std::uint64_t half = 0x3fe6a09e667f3bcdULL;
+  const std::int64_t k = (std::int64_t)(b - half) >> 52;
+  e = _int_to_double_(k + 1 - 55 * (std::int64_t)small);
+  return _double_(b - ((std::uint64_t)k << 52)) - 1;
+}
+// ========================================================================
+/** the correction of log and log2 for the special values of x:
+ *  -inf for zero, NaN for negative x and NaN, inf for inf, otherwise 0
+ */
+LHCBMATH_KERNEL double _log_special_(const double x) {
+  const std::uint64_t b = _bits_(x);
+  return _double_(0 == (b << 1) ? s_inf | s_sign
+                                : s_inf < b ? s_nan : s_inf == b ? s_inf : 0);
+}
+// ========================================================================
+/// natural logarithm, error below 1 ULP
+LHCBMATH_KERNEL double log(const double x) {
+  double e;
+  const double f = _frexp_(x, e);
+  double hfsq;
+  const double r = _log_reduced_(f, hfsq);
+  return (e * s_ln2_hi - ((hfsq - (r + e * s_ln2_lo)) - f)) +
+         _log_special_(x);
+}
+// ========================================================================
+/// binary logarithm, error below 1 ULP
+LHCBMATH_KERNEL double log2(const double x) {
+  double e;
+  const double f = _frexp_(x, e);
+  double hfsq;
+  const double r = _log_reduced_(f, hfsq);
+  // log(1+f)/log(2) with f split into the high and the low part
+  const double hi = _double_(_bits_(f - hfsq) & 0xffffffff00000000ULL);
+  const double lo = (f - hi) - hfsq + r;
+  const double vhi = hi * 1.44269504072144627571e+00;
+  const double vlo =
+      (lo + hi) * 1.67517131648865118353e-10 + lo * 1.44269504072144627571e+00;
+  // add the exponent with the rounding error of the sum kept
+  const double w = e + vhi;
+  return (((e - w) + vhi + vlo) + w) + _log_special_(x);
+}
+// ========================================================================
+/// exponent, error below 1 ULP
+LHCBMATH_KERNEL double exp(const double x) {
+  const double xmax = 7.09782712893383973096e+02;
+  const double xmin = -7.45133219101941108420e+02;
+  // keep 2^k in range: clamp |x| with integer operations, see _frexp_
+  const std::uint64_t b = _bits_(x);
+  const std::uint64_t neg = b >> 63;
+  const std::uint64_t limit =
+      neg ? _bits_(-xmin) : _bits_(xmax);
+  const std::uint64_t abs = b & ~s_sign;
+  const double xc = _double_((neg << 63) | (abs < limit ? abs : limit));
+  // k = round(x/log2) in the last bits of the shifted value
+  const double t0 = xc * s_inv_ln2 + s_shifter;
+  const std::int64_t k = _bits_(t0) - _bits_(s_shifter);
+  const double kd = t0 - s_shifter;
+  const double hi = xc - kd * s_ln2_hi;
+  const double lo = kd * s_ln2_lo;
+  const double r = hi - lo;
+  const double t = r * r;
+  const double c =
+      r - t * (1.66666666666666019037e-01 +
+               t * (-2.77777777770155933842e-03 +
+                    t * (6.61375632143793436117e-05 +
+                         t * (-1.65339022054652515390e-06 +
+                              t * 4.13813679705723846039e-08))));
+  const double y = 1 - ((lo - (r * c) / (2.0 - c)) - hi);
+  // y*2^k in two steps: both factors are normal, the last one rounds
+  const std::int64_t k1 = k >> 1;
+  const double s1 = _double_((std::uint64_t)(k1 + 1023) << 52);
+  const double s2 = _double_((std::uint64_t)(k - k1 + 1023) << 52);
+  // finally inf above xmax and 0 below xmin: at the ends y*2^k is close
+  // to the largest or to the smallest double, so multiply it by 2 or 1/2,
+  // with the flags from the sign bits, see _frexp_
+  const std::uint64_t over = ((_bits_(xmax) - b) >> 63) & ~neg;
+  const std::uint64_t under = ((_bits_(xmin) - b) >> 63) & neg;
+  const std::uint64_t scale = s_one + ((over - under) << 52);
+  // and NaN for NaN
+  return y * s1 * s2 * _double_(scale) + _double_(abs > s_inf ? s_nan : 0);
+}
+// ========================================================================
+/** logarithm of the gamma function for x>0, NaN otherwise.
+ *  The Stirling series for x>=10, below it x is shifted up by n<=10 and
+ *  the result is shifted down with log(x(x+1)...(x+n-1)), hence the
+ *  absolute (not relative) error bound near the zeros at x=1 and x=2.
+ */
+LHCBMATH_KERNEL double lgamma(const double x) {
+  // avoid inf-inf, lgamma(max) overflows anyway
+  const std::uint64_t bmax = _bits_(std::numeric_limits<double>::max());
+  const std::uint64_t b = _bits_(x);
+  const double xc = _double_(b < bmax ? b : bmax);
+  // z = x+n in [10,11) and the product x(x+1)...(x+n-1)
+  std::int64_t up = 0;
+  double p = 1;
+  for (int i = 0; i < 10; ++i) {
+    const double xi = xc + i;
+    const bool below = xi < 10;
+    // xi or 1 without a select, see _frexp_
+    const double w = _int_to_double_(below);
+    p *= xi * w + (1 - w);
+    up += below;
+  }
+  const double n = _int_to_double_(up);
+  // z+dz = x+n exactly (TwoSum)
+  const double z = xc + n;
+  const double zx = z - xc;
+  const double dz = (xc - (z - zx)) + (n - zx);
+  const double iz = 1 / z;
+  const double iz2 = iz * iz;
+  // B_2j/(2j(2j-1)z^(2j-1))
+  const double series =
+      iz *
+      (8.33333333333333333333e-02 +
+       iz2 * (-2.77777777777777777778e-03 +
+              iz2 * (7.93650793650793650794e-04 +
+                     iz2 * (-5.95238095238095238095e-04 +
+                            iz2 * (8.41750841750841750842e-04 +
+                                   iz2 * (-1.91752691752691752692e-03 +
+                                          iz2 * 6.41025641025641025641e-03))))));
+  const double lz = log(z);
+  // (z-1/2)*log(z) - z + log(2pi)/2, the large terms combined first
+  const double r = (z - 0.5) * (lz - 1) + (9.18938533204672741780e-01 - 0.5) +
+                   series + dz * (lz - 0.5 * iz);
+  // NaN for x<=0
+  const bool positive = b - 1 < s_inf; // 0<x<=inf
+  return (r - log(p)) + _double_(positive ? 0 : s_nan);
+}
+// ========================================================================
+/// a*b = p.hi+p.lo exactly: FMA if the target has it, Dekker's split if not
+LHCBMATH_KERNEL DD two_prod(const double a, const double b) {
+#if defined(__FMA__) || defined(__ARM_FEATURE_FMA)
+  const double p = a * b;
+  const DD r = {p, std::fma(a, b, -p)};
+  return r;
+#else
+  return two_prod_dekker(a, b);
+#endif
+}
+// ========================================================================
+/// DD + double
+LHCBMATH_KERNEL DD operator+(const DD &a, const double b) {
+  const DD s = two_sum(a.hi, b);
+  return fast_two_sum(s.hi, s.lo + a.lo);
+}
+/// DD + DD
+LHCBMATH_KERNEL DD operator+(const DD &a, const DD &b) {
+  const DD s = two_sum(a.hi, b.hi);
+  const DD t = two_sum(a.lo, b.lo);
+  const DD u = fast_two_sum(s.hi, s.lo + t.hi);
+  return fast_two_sum(u.hi, u.lo + t.lo);
+}
+/// -DD
+LHCBMATH_KERNEL DD operator-(const DD &a) {
+  const DD r = {-a.hi, -a.lo};
+  return r;
+}
+/// DD - double
+LHCBMATH_KERNEL DD operator-(const DD &a, const double b) { return a + (-b); }
+/// DD - DD
+LHCBMATH_KERNEL DD operator-(const DD &a, const DD &b) { return a + (-b); }
+// ========================================================================
+// the products and the quotient that overflow are {inf,0} as in double,
+// rather than NaN from inf-inf in the corrections
+// ========================================================================
+/// DD * double
+LHCBMATH_KERNEL DD operator*(const DD &a, const double b) {
+  const DD p = two_prod(a.hi, b);
+  if (!finite(p.hi)) {
+    const DD r = {p.hi, 0};
+    return r;
+  }
+  return fast_two_sum(p.hi, p.lo + a.lo * b);
+}
+/// DD * DD
+LHCBMATH_KERNEL DD operator*(const DD &a, const DD &b) {
+  const DD p = two_prod(a.hi, b.hi);
+  if (!finite(p.hi)) {
+    const DD r = {p.hi, 0};
+    return r;
+  }
+  return fast_two_sum(p.hi, p.lo + (a.hi * b.lo + a.lo * b.hi));
+}
+/// DD / double
+LHCBMATH_KERNEL DD operator/(const DD &a, const double b) {
+  const double q1 = a.hi / b;
+  if (!finite(q1)) {
+    const DD r = {q1, 0};
+    return r;
+  }
+  // the remainder a - q1*b
+  const DD p = two_prod(q1, b);
+  const DD s = two_sum(a.hi, -p.hi);
+  const double q2 = (s.hi + (s.lo - p.lo + a.lo)) / b;
+  return fast_two_sum(q1, q2);
+}
+// ========================================================================
+/** logarithm of x>0 (normal) in double-double, relative error ~1e-31.
+ *  Not vectorized: it fills tables and serves the log-gamma below.
+ */
+inline DD log_dd(const double x) {
+  double e;
+  const double f = _frexp_(x, e);
+  // s = f/(2+f) in double-double: log(1+f) = 2*atanh(s)
+  const DD d = two_sum(2, f);
+  const double sh = f / d.hi;
+  const DD p = two_prod(sh, d.hi);
+  const double sl = ((f - p.hi) - p.lo - sh * d.lo) / d.hi;
+  const DD s = fast_two_sum(sh, sl);
+  const DD z = s * s;
+  // atanh(s)/s = sum z^j/(2j+1), |z|<0.03: the terms from z^11 on are
+  // below 1e-16 of the sum and are added in double
+  double t = 1.0 / 43;
+  for (int j = 20; 11 <= j; --j) {
+    t = 1.0 / (2 * j + 1) + z.hi * t;
+  }
+  // 1/(2j+1) for j=1..10
+  const DD c[10] = {{0.33333333333333331, 1.8503717077085941e-17},
+                    {0.20000000000000001, -1.1102230246251566e-17},
+                    {0.14285714285714285, 7.9301644616082606e-18},
+                    {0.1111111111111111, 6.1679056923619804e-18},
+                    {0.090909090909090912, -2.5232341468753558e-18},
+                    {0.076923076923076927, -4.2700885562506023e-18},
+                    {0.066666666666666666, 9.251858538542971e-19},
+                    {0.058823529411764705, 8.1634045928320333e-19},
+                    {0.052631578947368418, 2.9216395384872539e-18},
+                    {0.047619047619047616, 2.6433881538694202e-18}};
+  DD u = {t, 0};
+  for (int j = 9; 0 <= j; --j) {
+    u = c[j] + z * u;
+  }
+  u = s + s * (z * u);
+  // log(2) in double-double: e*log(2) is exact in the leading part
+  const double ln2_hi = 0.69314718055994529;
+  const double ln2_lo = 2.3190468138462996e-17;
+  const DD l = two_prod(e, ln2_hi);
+  return (l + e * ln2_lo) + (u + u);
+}
+/// logarithm of x>0 in double-double
+inline DD log_dd(const DD &x) { return log_dd(x.hi) + x.lo / x.hi; }
+// ========================================================================
+/** log(Gamma(x)) for x>0 in double-double, absolute error ~1e-21:
+ *  x is shifted to [12,13) and the Stirling series is summed to 1/x^19.
+ *  Not vectorized: it serves the O(1) path of the large-k binomials.
+ */
+inline DD lgamma_dd(DD x) {
+  // Gamma(x) = Gamma(x+m)/(x(x+1)...(x+m-1))
+  DD p = {1, 0};
+  for (; x.hi < 12; x = x + 1.0) {
+    p = p * x;
+  }
+  // B_2n/(2n(2n-1)), n=2..10, summed in double
+  const double c[9] = {-1.0 / 360,         1.0 / 1260,
+                       -1.0 / 1680,        1.0 / 1188,
+                       -691.0 / 360360,    1.0 / 156,
+                       -3617.0 / 122400,   43867.0 / 244188,
+                       -174611.0 / 125400};
+  // 1/x and 1/12 in double-double
+  const DD one = {1, 0};
+  DD y = one / x.hi;
+  y = y + (-x.lo * y.hi * y.hi);
+  const DD c1 = {0.083333333333333329, 4.6259292692714853e-18};
+  const double y2 = y.hi * y.hi;
+  double t = c[8];
+  for (int j = 7; 0 <= j; --j) {
+    t = c[j] + y2 * t;
+  }
+  // log(2*pi)/2
+  const DD h = {0.91893853320467278, -3.8782941580672414e-17};
+  return (x - 0.5) * log_dd(x) - x + h + (c1 + y2 * t) * y - log_dd(p);
+}
+// ========================================================================
+/** sin(pi*x) for |x|<=1/2 in double-double, relative error ~1e-31
+ *  Not vectorized: it serves the reflection formula of the log-gamma.
+ */
+inline DD sinpi_dd(const DD &x) {
+  const DD pi = {3.1415926535897931, 1.2246467991473532e-16};
+  const DD u = pi * x;
+  const DD u2 = u * u;
+  // Taylor series, |u|<=pi/2: the terms beyond u^37 are below 1e-32
+  DD term = u;
+  DD s = u;
+  for (int j = 1; j <= 18; ++j) {
+    term = -(term * u2) / double((2 * j) * (2 * j + 1));
+    s = s + term;
+  }
+  return s;
+}
+// ========================================================================
+}
+// ==========================================================================
+}
+// back to the contraction of the command line
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT DEFAULT
+#endif
+#endif // LHCBMATH_MATHKERNELS_H
+// ============================================================================
@@ -6,6 +6,16 @@
 // STD & STL
 // ============================================================================
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+// ============================================================================
+// local
+// ============================================================================
+#include "LHCbMath/ExtendedTypes.h"
+#include "LHCbMath/Unroll.h"
 // ============================================================================
 /** @file
  *
@@ -27,10 +37,19 @@
  *  The actual code is copied from
  *     std::__cmath_power bits/cmath.tcc
  *
+ *  It is constexpr: with constant arguments it can define constants,
+ *  array sizes and template arguments.
+ *
+ *  @code
+ *
+ *   static_assert ( 1024 == pow ( 2 , 10 ) , "2^10" ) ;
+ *
+ *  @endcode
+ *
  *  @author Vanya BELYAEV Ivan.Belyaev@lapp.in2p3.fr
  *  @date 2005-04-09
  */
-template <typename TYPE> inline TYPE pow(TYPE __x, unsigned long __n) {
+template <typename TYPE> constexpr TYPE pow(TYPE __x, unsigned long __n) {
   //
   TYPE __y = __n % 2 ? __x : 1;
   //
@@ -43,5 +62,539 @@ template <typename TYPE> inline TYPE pow(TYPE __x, unsigned long __n) {
   //
   return __y;
 }
+// ============================================================================
+namespace Math {
+// ==========================================================================
+// the unqualified pow(x,n) in namespace Math still finds the one above
+using ::pow;
+// ==========================================================================
+namespace detail {
+// ========================================================================
+/** The shortest addition chains for n<=128: row n holds the elements of
+ *  the chain after 1, each one the sum of two earlier elements.
+ *  Found by the exhaustive search (iterative deepening) over all chains.
+ */
+constexpr unsigned char s_chains[129][10] = {
+    {},
+    {},
+    {2},
+    {2, 3},
+    {2, 4},
+    {2, 4, 5},
+    {2, 4, 6},
+    {2, 4, 6, 7},
+    {2, 4, 8},
+    {2, 4, 8, 9},
+    {2, 4, 8, 10},
+    {2, 4, 8, 10, 11},
+    {2, 4, 8, 12},
+    {2, 4, 8, 12, 13},
+    {2, 4, 8, 12, 14},
+    {2, 4, 5, 10, 15},
+    {2, 4, 8, 16},
+    {2, 4, 8, 16, 17},
+    {2, 4, 8, 16, 18},
+    {2, 4, 8, 16, 18, 19},
+    {2, 4, 8, 16, 20},
+    {2, 4, 8, 16, 20, 21},
+    {2, 4, 8, 16, 20, 22},
+    {2, 4, 5, 9, 18, 23},
+    {2, 4, 8, 16, 24},
+    {2, 4, 8, 16, 24, 25},
+    {2, 4, 8, 16, 24, 26},
+    {2, 4, 8, 9, 18, 27},
+    {2, 4, 8, 16, 24, 28},
+    {2, 4, 8, 16, 24, 28, 29},
+    {2, 4, 8, 10, 20, 30},
+    {2, 4, 8, 10, 20, 30, 31},
+    {2, 4, 8, 16, 32},
+    {2, 4, 8, 16, 32, 33},
+    {2, 4, 8, 16, 32, 34},
+    {2, 4, 8, 16, 32, 34, 35},
+    {2, 4, 8, 16, 32, 36},
+    {2, 4, 8, 16, 32, 36, 37},
+    {2, 4, 8, 16, 32, 36, 38},
+    {2, 4, 8, 12, 13, 26, 39},
+    {2, 4, 8, 16, 32, 40},
+    {2, 4, 8, 16, 32, 40, 41},
+    {2, 4, 8, 16, 32, 40, 42},
+    {2, 4, 8, 9, 17, 34, 43},
+    {2, 4, 8, 16, 32, 40, 44},
+    {2, 4, 8, 9, 18, 36, 45},
+    {2, 4, 8, 10, 18, 36, 46},
+    {2, 4, 8, 12, 13, 26, 39, 47},
+    {2, 4, 8, 16, 32, 48},
+    {2, 4, 8, 16, 32, 48, 49},
+    {2, 4, 8, 16, 32, 48, 50},
+    {2, 4, 8, 16, 17, 34, 51},
+    {2, 4, 8, 16, 32, 48, 52},
+    {2, 4, 8, 16, 32, 48, 52, 53},
+    {2, 4, 8, 16, 18, 36, 54},
+    {2, 4, 8, 16, 18, 36, 54, 55},
+    {2, 4, 8, 16, 32, 48, 56},
+    {2, 4, 8, 16, 32, 48, 56, 57},
+    {2, 4, 8, 16, 32, 48, 56, 58},
+    {2, 4, 8, 16, 17, 34, 51, 59},
+    {2, 4, 8, 16, 20, 40, 60},
+    {2, 4, 8, 16, 20, 40, 60, 61},
+    {2, 4, 8, 16, 20, 40, 60, 62},
+    {2, 4, 8, 16, 20, 21, 42, 63},
+    {2, 4, 8, 16, 32, 64},
+    {2, 4, 8, 16, 32, 64, 65},
+    {2, 4, 8, 16, 32, 64, 66},
+    {2, 4, 8, 16, 32, 64, 66, 67},
+    {2, 4, 8, 16, 32, 64, 68},
+    {2, 4, 8, 16, 32, 64, 68, 69},
+    {2, 4, 8, 16, 32, 64, 68, 70},
+    {2, 4, 8, 16, 32, 64, 68, 70, 71},
+    {2, 4, 8, 16, 32, 64, 72},
+    {2, 4, 8, 16, 32, 64, 72, 73},
+    {2, 4, 8, 16, 32, 64, 72, 74},
+    {2, 4, 8, 16, 24, 25, 50, 75},
+    {2, 4, 8, 16, 32, 64, 72, 76},
+    {2, 4, 8, 9, 17, 34, 68, 77},
+    {2, 4, 8, 16, 24, 26, 52, 78},
+    {2, 4, 8, 16, 24, 26, 52, 78, 79},
+    {2, 4, 8, 16, 32, 64, 80},
+    {2, 4, 8, 16, 32, 64, 80, 81},
+    {2, 4, 8, 16, 32, 64, 80, 82},
+    {2, 4, 8, 16, 17, 33, 66, 83},
+    {2, 4, 8, 16, 32, 64, 80, 84},
+    {2, 4, 8, 16, 17, 34, 68, 85},
+    {2, 4, 8, 16, 18, 34, 68, 86},
+    {2, 4, 8, 16, 24, 28, 29, 58, 87},
+    {2, 4, 8, 16, 32, 64, 80, 88},
+    {2, 4, 8, 16, 32, 64, 80, 88, 89},
+    {2, 4, 8, 16, 18, 36, 72, 90},
+    {2, 4, 8, 16, 24, 25, 50, 75, 91},
+    {2, 4, 8, 16, 20, 36, 72, 92},
+    {2, 4, 8, 16, 20, 36, 72, 92, 93},
+    {2, 4, 8, 16, 24, 26, 52, 78, 94},
+    {2, 4, 8, 16, 20, 21, 37, 74, 95},
+    {2, 4, 8, 16, 32, 64, 96},
+    {2, 4, 8, 16, 32, 64, 96, 97},
+    {2, 4, 8, 16, 32, 64, 96, 98},
+    {2, 4, 8, 16, 32, 33, 66, 99},
+    {2, 4, 8, 16, 32, 64, 96, 100},
+    {2, 4, 8, 16, 32, 64, 96, 100, 101},
+    {2, 4, 8, 16, 32, 34, 68, 102},
+    {2, 4, 8, 16, 32, 34, 68, 102, 103},
+    {2, 4, 8, 16, 32, 64, 96, 104},
+    {2, 4, 8, 16, 32, 64, 96, 104, 105},
+    {2, 4, 8, 16, 32, 64, 96, 104, 106},
+    {2, 4, 8, 16, 32, 33, 66, 99, 107},
+    {2, 4, 8, 16, 32, 36, 72, 108},
+    {2, 4, 8, 16, 32, 36, 72, 108, 109},
+    {2, 4, 8, 16, 32, 36, 72, 108, 110},
+    {2, 4, 8, 16, 32, 36, 37, 74, 111},
+    {2, 4, 8, 16, 32, 64, 96, 112},
+    {2, 4, 8, 16, 32, 64, 96, 112, 113},
+    {2, 4, 8, 16, 32, 64, 96, 112, 114},
+    {2, 4, 8, 16, 32, 33, 66, 99, 115},
+    {2, 4, 8, 16, 32, 64, 96, 112, 116},
+    {2, 4, 8, 16, 17, 34, 50, 100, 117},
+    {2, 4, 8, 16, 32, 34, 68, 102, 118},
+    {2, 4, 8, 16, 17, 34, 68, 102, 119},
+    {2, 4, 8, 16, 32, 40, 80, 120},
+    {2, 4, 8, 16, 32, 40, 80, 120, 121},
+    {2, 4, 8, 16, 32, 40, 80, 120, 122},
+    {2, 4, 8, 16, 32, 40, 41, 82, 123},
+    {2, 4, 8, 16, 32, 40, 80, 120, 124},
+    {2, 4, 8, 16, 24, 25, 50, 100, 125},
+    {2, 4, 8, 16, 32, 40, 42, 84, 126},
+    {2, 4, 8, 16, 32, 40, 42, 84, 126, 127},
+    {2, 4, 8, 16, 32, 64, 128},
+};
+// ========================================================================
+/// the number of multiplications in the chain of n<=128
+constexpr unsigned int chain_length(const unsigned int n) {
+  unsigned int l = 0;
+  while (l < 10 && 0 != s_chains[n][l]) {
+    ++l;
+  }
+  return l;
+}
+/// the element i of the chain of n, the element 0 is 1
+constexpr unsigned int chain_element(const unsigned int n,
+                                     const unsigned int i) {
+  return 0 == i ? 1 : s_chains[n][i - 1];
+}
+/** the index j or k (second) of the earlier elements
+ *  with element(i) = element(j) + element(k), j>=k
+ */
+constexpr unsigned int chain_operand(const unsigned int n,
+                                     const unsigned int i,
+                                     const bool second) {
+  for (unsigned int j = i; 0 < j--;) {
+    for (unsigned int k = j + 1; 0 < k--;) {
+      if (chain_element(n, j) + chain_element(n, k) == chain_element(n, i)) {
+        return second ? k : j;
+      }
+    }
+  }
+  return 0;
+}
+// ========================================================================
+/// one of TYPE: the vector types do not convert from scalars
+template <class TYPE> constexpr TYPE one() { return TYPE{} + 1; }
+// ========================================================================
+/// the steps I..L of the chain of N: v[i] = v[j] * v[k]
+template <unsigned int N, unsigned int I, unsigned int L = chain_length(N)>
+struct PowerChain {
+  template <class TYPE> static constexpr TYPE apply(TYPE *v) {
+    v[I] = v[chain_operand(N, I, false)] * v[chain_operand(N, I, true)];
+    return PowerChain<N, I + 1, L>::apply(v);
+  }
+};
+template <unsigned int N, unsigned int L> struct PowerChain<N, L, L> {
+  template <class TYPE> static constexpr TYPE apply(TYPE *v) {
+    return v[L] = v[chain_operand(N, L, false)] * v[chain_operand(N, L, true)];
+  }
+};
+// ========================================================================
+/** x^N: the shortest addition chain for N<=128,
+ *  beyond it x^N = (x^(N/2))^2 * x^(N%2)
+ */
+template <unsigned int N, bool CHAIN = N <= 128> struct Power {
+  template <class TYPE> static constexpr TYPE apply(const TYPE x) {
+    const TYPE h = Power<N / 2>::apply(x);
+    return N % 2 ? h * h * x : h * h;
+  }
+};
+template <unsigned int N> struct Power<N, true> {
+  template <class TYPE> static constexpr TYPE apply(const TYPE x) {
+    TYPE v[chain_length(N) + 1] = {x};
+    return PowerChain<N, 1>::apply(v);
+  }
+};
+template <> struct Power<1, true> {
+  template <class TYPE> static constexpr TYPE apply(const TYPE x) {
+    return x;
+  }
+};
+template <> struct Power<0, true> {
+  template <class TYPE> static constexpr TYPE apply(const TYPE) {
+    return one<TYPE>();
+  }
+};
+// ========================================================================
+}
+// ==========================================================================
+/** x^N for the exponent known at compile time, N of any sign.
+ *  The multiplications follow the shortest addition chain of |N| for
+ *  |N|<=128, e.g. x^15 = x^10 * x^5 with x^2, x^4, x^5, x^10: 5 instead
+ *  of 6 of the square-and-multiply. Negative N cost one division.
+ *  It is constexpr and works for the arithmetic types and for the SIMD
+ *  vector types with operator*, operator/ and operator+ with scalars.
+ *
+ *  @code
+ *
+ *   static_assert ( 1.0 / 32 == Math::pow<-5> ( 2.0 ) , "2^-5" ) ;
+ *   const double x15 = Math::pow<15> ( x ) ;
+ *
+ *  @endcode
+ */
+template <int N, class TYPE> constexpr TYPE pow(const TYPE x) {
+  const TYPE y = detail::Power<(N < 0 ? 0u - N : N)>::apply(x);
+  return N < 0 ? detail::one<TYPE>() / y : y;
+}
+// ==========================================================================
+/** out[i] = x[i]^n for i<size, identical to pow(x[i],n) above.
+ *  The squares of x are shared over blocks of the array: the loops are
+ *  vectorized, with AVX2 and AVX-512 versions chosen at load time.
+ *  out may be x.
+ */
+void pow(const double *x, const unsigned long n, double *out,
+         const std::size_t size);
+// ==========================================================================
+/** out[i] = x[i]^n[i] for i<size, identical to pow(x[i],n[i]) above.
+ *  The square-and-multiply runs over the bits of all exponents of a block,
+ *  each element takes the products of its own bits: vectorized as above,
+ *  the cost follows the largest exponent of the block.
+ *  out may be x.
+ */
+void pow(const double *x, const unsigned long *n, double *out,
+         const std::size_t size);
+// ==========================================================================
+/** x^n for the integer TYPE with saturation: unlike pow(x,n) above it
+ *  does not wrap around. In case of overflow the largest TYPE is returned,
+ *  or the smallest one for the negative results, and *overflow is set.
+ *
+ *  @code
+ *
+ *   bool overflow = false ;
+ *   const unsigned long long p = Math::pow_checked ( 2ULL , k , &overflow ) ;
+ *
+ *  @endcode
+ */
+template <class TYPE>
+constexpr TYPE pow_checked(TYPE x, unsigned long n, bool *overflow = nullptr) {
+  static_assert(std::is_integral<TYPE>::value,
+                "Math::pow_checked: TYPE must be an integer type");
+  // the sign of the result, without comparing unsigned x with 0
+  const bool negative = n % 2 && x != 0 && !(x > 0);
+  TYPE y = n % 2 ? x : 1;
+  bool o = false;
+  while (!o && (n >>= 1)) {
+    o = __builtin_mul_overflow(x, x, &x) ||
+        (n % 2 && __builtin_mul_overflow(y, x, &y));
+  }
+  if (overflow) {
+    *overflow = o;
+  }
+  return !o ? y
+            : negative ? std::numeric_limits<TYPE>::min()
+                       : std::numeric_limits<TYPE>::max();
+}
+// ==========================================================================
+/** @class Montgomery
+ *  Multiplication and powers modulo the odd m<2^64 in the Montgomery form
+ *  x*2^64 mod m: the products are reduced with two multiplications
+ *  instead of the 128-bit division. The constructor costs one 128-bit
+ *  division, keep the object for the repeated powers with the same m.
+ *
+ *  @code
+ *
+ *   const Math::Montgomery mont ( m ) ;
+ *   const std::uint64_t h = mont.pow ( x , n ) ; // x^n mod m
+ *
+ *  @endcode
+ */
+class Montgomery {
+public:
+  // ========================================================================
+  /// the odd modulus m
+  constexpr explicit Montgomery(const std::uint64_t m)
+      : m_m(m), m_inv(_inverse_(m)), m_one((0 - m) % m),
+        m_r2(UINT128(m_one) * m_one % m) {}
+  // ========================================================================
+public:
+  // ========================================================================
+  /// the modulus
+  constexpr std::uint64_t modulus() const { return m_m; }
+  /// a*b mod m
+  constexpr std::uint64_t mul(const std::uint64_t a,
+                              const std::uint64_t b) const {
+    return _reduce_(UINT128(_to_(a)) * _to_(b));
+  }
+  /// x^n mod m
+  constexpr std::uint64_t pow(const std::uint64_t x, unsigned long n) const {
+    std::uint64_t s = _to_(x);
+    std::uint64_t y = n % 2 ? s : m_one;
+    while (n >>= 1) {
+      s = _reduce_(UINT128(s) * s);
+      if (n % 2) {
+        y = _reduce_(UINT128(y) * s);
+      }
+    }
+    return _reduce_(y);
+  }
+  // ========================================================================
+private:
+  // ========================================================================
+  /// 1/m mod 2^64 by Newton iterations: each doubles the correct bits
+  static constexpr std::uint64_t _inverse_(const std::uint64_t m) {
+    std::uint64_t x = m; // correct to 3 bits
+    for (unsigned int i = 0; i < 5; ++i) {
+      x *= 2 - m * x;
+    }
+    return x;
+  }
+  /// t/2^64 mod m for t<m*2^64: the low words of t and u*m cancel
+  constexpr std::uint64_t _reduce_(const UINT128 t) const {
+    const std::uint64_t u = std::uint64_t(t) * m_inv;
+    const std::uint64_t hi = std::uint64_t(t >> 64);
+    const std::uint64_t um = std::uint64_t(UINT128(u) * m_m >> 64);
+    return hi >= um ? hi - um : hi - um + m_m;
+  }
+  /// x*2^64 mod m
+  constexpr std::uint64_t _to_(const std::uint64_t x) const {
+    return _reduce_(UINT128(x % m_m) * m_r2);
+  }
+  // ========================================================================
+private:
+  // ========================================================================
+  /// the modulus
+  std::uint64_t m_m;
+  /// 1/m mod 2^64
+  std::uint64_t m_inv;
+  /// 2^64 mod m: one in the Montgomery form
+  std::uint64_t m_one;
+  /// 2^128 mod m
+  std::uint64_t m_r2;
+  // ========================================================================
+};
+// ==========================================================================
+/** x^n mod m for 0<m<2^64: in the Montgomery form for odd m, with the
+ *  128-bit products and divisions for even m
+ *  @see Math::Montgomery
+ */
+constexpr std::uint64_t pow_mod(std::uint64_t x, unsigned long n,
+                                const std::uint64_t m) {
+  if (m % 2) {
+    return Montgomery(m).pow(x, n);
+  }
+  x %= m;
+  std::uint64_t y = n % 2 ? x : 1 % m;
+  while (n >>= 1) {
+    x = UINT128(x) * x % m;
+    if (n % 2) {
+      y = UINT128(y) * x % m;
+    }
+  }
+  return y;
+}
+// ==========================================================================
+namespace detail {
+// ========================================================================
+/** c = a*b for the NxN matrices, c distinct from a and b.
+ *  Each row of c is summed in the registers over the rows of b:
+ *  N<=8 doubles of the row are one or two vector registers.
+ */
+template <class TYPE, std::size_t N>
+void matrix_multiply(const TYPE (&a)[N][N], const TYPE (&b)[N][N],
+                     TYPE (&c)[N][N]) {
+  LHCBMATH_UNROLL(8)
+  for (std::size_t i = 0; i < N; ++i) {
+    TYPE r[N];
+    LHCBMATH_UNROLL(8)
+    for (std::size_t j = 0; j < N; ++j) {
+      r[j] = a[i][0] * b[0][j];
+    }
+    LHCBMATH_UNROLL(8)
+    for (std::size_t k = 1; k < N; ++k) {
+      LHCBMATH_UNROLL(8)
+      for (std::size_t j = 0; j < N; ++j) {
+        r[j] += a[i][k] * b[k][j];
+      }
+    }
+    LHCBMATH_UNROLL(8)
+    for (std::size_t j = 0; j < N; ++j) {
+      c[i][j] = r[j];
+    }
+  }
+}
+// ========================================================================
+/// c = a*b truncated to K terms, c distinct from a and b
+template <class TYPE, std::size_t K>
+void series_multiply(const TYPE (&a)[K], const TYPE (&b)[K], TYPE (&c)[K]) {
+  for (std::size_t j = 0; j < K; ++j) {
+    c[j] = a[0] * b[j];
+  }
+  for (std::size_t i = 1; i < K; ++i) {
+    for (std::size_t j = 0; j + i < K; ++j) {
+      c[i + j] += a[i] * b[j];
+    }
+  }
+}
+// ========================================================================
+/// c = a*a truncated to K terms with the symmetric products once
+template <class TYPE, std::size_t K>
+void series_square(const TYPE (&a)[K], TYPE (&c)[K]) {
+  for (std::size_t j = 0; j < K; ++j) {
+    c[j] = TYPE{};
+  }
+  for (std::size_t i = 0; 2 * i < K; ++i) {
+    c[2 * i] += a[i] * a[i];
+    const TYPE d = a[i] + a[i];
+    for (std::size_t j = i + 1; i + j < K; ++j) {
+      c[i + j] += d * a[j];
+    }
+  }
+}
+// ========================================================================
+}
+// ==========================================================================
+/** out = a^n for the NxN matrix: the square-and-multiply of pow(x,n)
+ *  with the products written into the fixed buffers on the stack,
+ *  no temporary matrices are created. a^0 is the unit matrix.
+ *  Meant for the small matrices, 2x2 to 8x8. out may be a.
+ *
+ *  @code
+ *
+ *   double t[4][4] = { ... } ; // the transfer matrix
+ *   double t100[4][4] ;
+ *   Math::pow ( t , 100 , t100 ) ;
+ *
+ *  @endcode
+ */
+template <class TYPE, std::size_t N>
+void pow(const TYPE (&a)[N][N], unsigned long n, TYPE (&out)[N][N]) {
+  TYPE b1[N][N];
+  TYPE b2[N][N];
+  // the square, the result and the free buffer, rotated after each product
+  TYPE(*s)[N][N] = &b1;
+  TYPE(*y)[N][N] = &out;
+  TYPE(*t)[N][N] = &b2;
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < N; ++j) {
+      (*s)[i][j] = a[i][j];
+    }
+  }
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < N; ++j) {
+      (*y)[i][j] = n % 2 ? (*s)[i][j] : TYPE(i == j);
+    }
+  }
+  while (n >>= 1) {
+    detail::matrix_multiply(*s, *s, *t);
+    std::swap(s, t);
+    if (n % 2) {
+      detail::matrix_multiply(*y, *s, *t);
+      std::swap(y, t);
+    }
+  }
+  if (y != &out) {
+    for (std::size_t i = 0; i < N; ++i) {
+      for (std::size_t j = 0; j < N; ++j) {
+        out[i][j] = (*y)[i][j];
+      }
+    }
+  }
+}
+// ==========================================================================
+/** out = p^n for the polynomial p[0] + p[1]*x + ... + p[K-1]*x^(K-1)
+ *  truncated to the same K terms: the power series up to x^(K-1).
+ *  The same square-and-multiply as for the matrices, without temporaries;
+ *  the squares take the symmetric products once. out may be p.
+ *
+ *  @code
+ *
+ *   const double p[5] = { 1 , 1 } ; // 1+x
+ *   double q[5] ;
+ *   Math::pow_series ( p , 10 , q ) ; // 1 + 10x + 45x^2 + 120x^3 + 210x^4
+ *
+ *  @endcode
+ */
+template <class TYPE, std::size_t K>
+void pow_series(const TYPE (&p)[K], unsigned long n, TYPE (&out)[K]) {
+  TYPE b1[K];
+  TYPE b2[K];
+  // the square, the result and the free buffer, rotated after each product
+  TYPE(*s)[K] = &b1;
+  TYPE(*y)[K] = &out;
+  TYPE(*t)[K] = &b2;
+  for (std::size_t i = 0; i < K; ++i) {
+    (*s)[i] = p[i];
+  }
+  for (std::size_t i = 0; i < K; ++i) {
+    (*y)[i] = n % 2 ? (*s)[i] : TYPE(0 == i);
+  }
+  while (n >>= 1) {
+    detail::series_square(*s, *t);
+    std::swap(s, t);
+    if (n % 2) {
+      detail::series_multiply(*y, *s, *t);
+      std::swap(y, t);
+    }
+  }
+  if (y != &out) {
+    for (std::size_t i = 0; i < K; ++i) {
+      out[i] = (*y)[i];
+    }
+  }
+}
+// ==========================================================================
+}
 #endif // LHCBMATH_POWER_H
 // ============================================================================
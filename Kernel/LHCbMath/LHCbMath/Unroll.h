@@ -0,0 +1,27 @@
+#ifndef LHCBMATH_UNROLL_H
+#define LHCBMATH_UNROLL_H 1
+// ============================================================================
+/** @file
+ *  LHCBMATH_UNROLL(N) before a loop asks the compiler to unroll it N times:
+ *  "#pragma GCC unroll" for GCC>=8, "#pragma unroll" for clang, nothing
+ *  for the compilers that would warn about the unknown pragma.
+ *
+ *  @code
+ *
+ *   LHCBMATH_UNROLL(8)
+ *   for ( std::size_t i = 0 ; i < 8 ; ++i ) { ... }
+ *
+ *  @endcode
+ */
+// ============================================================================
+#define LHCBMATH_PRAGMA(x) _Pragma(#x)
+#if defined(__clang__)
+#define LHCBMATH_UNROLL(N) LHCBMATH_PRAGMA(unroll N)
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define LHCBMATH_UNROLL(N) LHCBMATH_PRAGMA(GCC unroll N)
+#else
+#define LHCBMATH_UNROLL(N)
+#endif
+// ============================================================================
+#endif // LHCBMATH_UNROLL_H
+// ============================================================================
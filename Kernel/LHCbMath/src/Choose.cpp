@@ -6,14 +6,19 @@
 // ============================================================================
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
+#include <vector>
 
 // ============================================================================
 // local
 // ============================================================================
 #include "LHCbMath/Choose.h"
+#include "LHCbMath/ChooseExact.h"
+#include "LHCbMath/ChooseInline.h"
 #include "LHCbMath/LHCbMath.h"
-#include "LHCbMath/Power.h"
+#include "LHCbMath/MathKernels.h"
 
 // ============================================================================
 /** @file
@@ -24,40 +29,808 @@
 // ============================================================================
 namespace {
 // ==========================================================================
-typedef std::numeric_limits<unsigned long long> ULLTYPE;
-static_assert(ULLTYPE::is_specialized,
-              "numeric_limits<unsigned long long> is not specialzaed!");
+// the scalar algorithms are those of Math::Inline
+using namespace Math::Inline::detail;
+/// the tables of Math::Inline
+const Pascal &s_pascal = ChooseTables::pascal;
+const Reciprocals<unsigned long long, Pascal::kmax> &s_reciprocals =
+    ChooseTables::reciprocals;
 // ==========================================================================
-const unsigned long long s_ullmax = ULLTYPE::max();
-const long double s_emax = std::log(0.2L * s_ullmax);
-const unsigned short s_digits = ULLTYPE::digits - 2;
+/// the logarithm of the largest double
+const double s_logmax =
+    Math::Kernels::log(std::numeric_limits<double>::max());
 // ==========================================================================
-/** calculate the binomial coefficient C(k,n) = n!/((n-k)!*k!)
- *  In case of overflow std::numeric_limits<unsigned long long>::max is returned
+/// zero for doubles
+const Zero<double> s_zero{}; // zero for doubles
+// ==========================================================================
+/** C(n,k) for n<=Pascal::nmax without branches, suitable for vectorization.
+ *  For larger n the result is meaningless and must be overwritten.
  */
-inline unsigned long long _choose_(unsigned short n, unsigned short k) {
+inline unsigned long long _choose_small_(const unsigned short n,
+                                         const unsigned short k) {
+  const unsigned short m = n <= Pascal::nmax ? n : 0;
+  const unsigned short j = k <= m ? k : 0;
+  const unsigned long long r = s_pascal(m, 2 * j < m ? j : m - j);
+  return k <= n ? r : 0;
+}
+// ==========================================================================
+/// the block size for batch evaluation, one word of the saturation mask
+const std::size_t s_block = 64;
+// ==========================================================================
+/// out[i] = exp(in[i]) for i<s_block, the fixed size lets it vectorize
+LHCBMATH_TARGET_CLONES
+void _exp_block_(const double *in, double *out) {
+  for (std::size_t i = 0; i < s_block; ++i) {
+    out[i] = Math::Kernels::exp(in[i]);
+  }
+}
+// ==========================================================================
+/// out[i] = log(in[i]) for i<s_block, the fixed size lets it vectorize
+LHCBMATH_TARGET_CLONES
+void _log_block_(const double *in, double *out) {
+  for (std::size_t i = 0; i < s_block; ++i) {
+    out[i] = Math::Kernels::log(in[i]);
+  }
+}
+// ==========================================================================
+/** out[i] = sum C(a,k)*x[i]^k over k<=K for i<s_block: C(a,k) follows
+ *  from the double-double recurrence once per block, the powers are
+ *  kept per lane
+ */
+LHCBMATH_TARGET_CLONES
+void _series_block_(const double a, const unsigned short K, const double *x,
+                    double *out) {
+  double p[s_block];
+  std::fill(p, p + s_block, 1.0);
+  std::fill(out, out + s_block, 1.0);
+  const Math::Kernels::DD ad = {a, 0};
+  Math::Kernels::DD c = {1, 0};
+  int e = 0;
+  for (unsigned short k = 0; k < K; ++k) {
+    c = _gen_choose_step_(c, e, ad, k);
+    if (0 == c.hi) {
+      break;
+    } // integer a: the series terminates
+    const double ck = 0 == e ? c.hi : std::ldexp(c.hi, e);
+    for (std::size_t i = 0; i < s_block; ++i) {
+      p[i] *= x[i];
+      out[i] += ck * p[i];
+    }
+  }
+}
+// ==========================================================================
+/** fill out[k] = C(n,k) for k<=n/2 as long as C(n,k) fits into
+ *  unsigned long long, return the first k for which it does not fit
+ */
+template <class TYPE>
+inline unsigned short _choose_row_exact_(const unsigned short n, TYPE *out) {
+  const unsigned short h = n / 2;
+  if (n <= Pascal::nmax) {
+    for (unsigned short k = 0; k <= h; ++k) {
+      out[k] = s_pascal(n, k);
+    }
+    return h + 1;
+  }
   //
-  if (k > n) {
+  out[0] = 1;
+  unsigned long long r = 1;
+  unsigned short k = 1;
+  for (; k <= h && s_pascal.fits(n, k); ++k) {
+    r = s_reciprocals.divide((Math::UINT128)r * (n - k + 1), k);
+    out[k] = r;
+  }
+  return k;
+}
+// ==========================================================================
+/// fill the second half of the row using C(n,k) = C(n,n-k)
+template <class TYPE>
+inline void _mirror_row_(const unsigned short n, TYPE *out) {
+  for (unsigned short k = 0; 2 * k < n; ++k) {
+    out[n - k] = out[k];
+  }
+}
+// ==========================================================================
+// The precision policies of Math::Binomial
+// ==========================================================================
+/// the tag of the result type
+template <class T> struct As {};
+// ==========================================================================
+// double: the algorithms above
+// ==========================================================================
+inline double _choose_as_(const unsigned short n, const unsigned short k,
+                          As<double>) {
+  return _choose_double_(n, k);
+}
+inline double _log_choose_as_(const unsigned short n, const unsigned short k,
+                              As<double>) {
+  return _log_choose_(n, k);
+}
+inline double _log_factorial_as_(const unsigned short n, As<double>) {
+  return _log_factorials_()(n);
+}
+inline double _gen_choose_as_(const double a, const unsigned short k,
+                              As<double>) {
+  return s_zero(a) ? 0 : _gen_choose_(a, k);
+}
+// ==========================================================================
+void _choose_as_(const unsigned short *n, const unsigned short *k, double *out,
+                 const std::size_t size, As<double>) {
+  for (std::size_t i = 0; i < size; ++i) {
+    out[i] = _choose_small_(n[i], k[i]);
+  }
+  // large n: exact or exp(log(n!)-log(k!)-log((n-k)!)), one block at a time
+  double arg[s_block];
+  double res[s_block];
+  for (std::size_t i0 = 0; i0 < size; i0 += s_block) {
+    const std::size_t i1 = std::min(size, i0 + s_block);
+    std::uint64_t mask = 0;
+    std::fill(arg, arg + s_block, 0.0);
+    for (std::size_t i = i0; i < i1; ++i) {
+      const unsigned short ni = n[i];
+      const unsigned short ki = k[i];
+      if (ni <= Pascal::nmax || ki > ni) {
+        continue;
+      }
+      const unsigned short k1 = 2 * ki < ni ? ki : ni - ki;
+      if (s_pascal.fits(ni, k1)) {
+        out[i] = _choose_exact_(ni, k1);
+      } else {
+        const LogFactorials &lf = _log_factorials_();
+        arg[i - i0] = lf(ni) - lf(ni - ki) - lf(ki);
+        mask |= std::uint64_t(1) << (i - i0);
+      }
+    }
+    if (!mask) {
+      continue;
+    }
+    _exp_block_(arg, res);
+    for (std::size_t i = i0; i < i1; ++i) {
+      out[i] = mask >> (i - i0) & 1 ? res[i - i0] : out[i];
+    }
+  }
+}
+// ==========================================================================
+void _log_choose_as_(const unsigned short *n, const unsigned short *k,
+                     double *out, const std::size_t size, As<double>) {
+  // exact values go through log, one block at a time
+  double arg[s_block];
+  double res[s_block];
+  for (std::size_t i0 = 0; i0 < size; i0 += s_block) {
+    const std::size_t i1 = std::min(size, i0 + s_block);
+    std::uint64_t mask = 0;
+    std::fill(arg, arg + s_block, 1.0);
+    for (std::size_t i = i0; i < i1; ++i) {
+      const unsigned short ni = n[i];
+      const unsigned short ki = k[i];
+      if (0 == ki || ki >= ni) {
+        out[i] = 0;
+        continue;
+      }
+      const unsigned short k1 = 2 * ki < ni ? ki : ni - ki;
+      if (ni <= Pascal::nmax) {
+        arg[i - i0] = s_pascal(ni, k1);
+      } else if (s_pascal.fits(ni, k1)) {
+        arg[i - i0] = _choose_exact_(ni, k1);
+      } else {
+        const LogFactorials &lf = _log_factorials_();
+        out[i] = lf(ni) - lf(ni - ki) - lf(ki);
+        continue;
+      }
+      mask |= std::uint64_t(1) << (i - i0);
+    }
+    if (!mask) {
+      continue;
+    }
+    _log_block_(arg, res);
+    for (std::size_t i = i0; i < i1; ++i) {
+      out[i] = mask >> (i - i0) & 1 ? res[i - i0] : out[i];
+    }
+  }
+}
+// ==========================================================================
+// float: the double algorithms rounded once, except for the generalized
+// coefficients which skip the double-double arithmetic.
+// A float table of log(n!) would not do: its entries reach 6.6e5 where
+// the spacing of floats is 0.06, and log C(n,k) is their difference.
+// ==========================================================================
+/// k above which the float C(a,k) is taken from the double lgamma ratio
+const unsigned short s_gen_choose_kmax_float = 48;
+// ==========================================================================
+/// C(a,k) as the product in double, relative error below 2k*2^-53
+inline double _gen_choose_product_double_(const double a,
+                                          const unsigned short k) {
+  double r = 1;
+  for (unsigned short j = 0; j < k; ++j) {
+    r = r * (a - j) / (j + 1);
+  }
+  return r;
+}
+// ==========================================================================
+/** C(a,k) from the ratio of gamma functions in double, see _gen_choose_log_.
+ *  Within the range of float the relative error is below 1e-8.
+ */
+inline double _gen_choose_lgamma_(const double a, const unsigned short k) {
+  using Math::Kernels::lgamma;
+  const double lk = lgamma(k + 1.0);
+  if (k - 1 < a) {
+    return Math::Kernels::exp(lgamma(a + 1) - lk - lgamma(a - k + 1));
+  } else if (a < 0) {
+    const double r = Math::Kernels::exp(lgamma(k - a) - lk - lgamma(-a));
+    return 0 == k % 2 ? r : -r;
+  }
+  const double m = std::nearbyint(a);
+  const double f = a - m;
+  if (0 == f) {
     return 0;
-  } else if (0 == k || n == k) {
-    return 1;
   }
-  //
-  k = std::min(k, (unsigned short)(n - k));
+  const double pi = 3.14159265358979323846;
+  const double sf = std::sin(pi * f);
+  const double r = Math::Kernels::exp(lgamma(a + 1) + lgamma(k - a) - lk +
+                                      Math::Kernels::log(std::abs(sf) / pi));
+  return (k - 1 + int(m) + (f < 0)) % 2 ? -r : r;
+}
+// ==========================================================================
+inline float _choose_as_(const unsigned short n, const unsigned short k,
+                         As<float>) {
+  return float(_choose_double_(n, k));
+}
+inline float _log_choose_as_(const unsigned short n, const unsigned short k,
+                             As<float>) {
+  return float(_log_choose_(n, k));
+}
+inline float _log_factorial_as_(const unsigned short n, As<float>) {
+  return float(_log_factorials_()(n));
+}
+inline float _gen_choose_as_(const double a, const unsigned short k,
+                             As<float>) {
+  return float(k <= s_gen_choose_kmax_float
+                   ? _gen_choose_product_double_(a, k)
+                   : s_gen_choose_amax <= std::abs(a)
+                         ? _gen_choose_inf_(a, k)
+                         : _gen_choose_lgamma_(a, k));
+}
+// ==========================================================================
+/// the double blocks rounded to float
+void _choose_as_(const unsigned short *n, const unsigned short *k, float *out,
+                 const std::size_t size, As<float>) {
+  double buffer[s_block];
+  for (std::size_t i0 = 0; i0 < size; i0 += s_block) {
+    const std::size_t m = std::min(size - i0, s_block);
+    _choose_as_(n + i0, k + i0, buffer, m, As<double>());
+    std::copy(buffer, buffer + m, out + i0);
+  }
+}
+void _log_choose_as_(const unsigned short *n, const unsigned short *k,
+                     float *out, const std::size_t size, As<float>) {
+  double buffer[s_block];
+  for (std::size_t i0 = 0; i0 < size; i0 += s_block) {
+    const std::size_t m = std::min(size - i0, s_block);
+    _log_choose_as_(n + i0, k + i0, buffer, m, As<double>());
+    std::copy(buffer, buffer + m, out + i0);
+  }
+}
+// ==========================================================================
+// long double: double-double (106 bits) rounded once, enough for the
+// 64-bit significand of the x87 format
+// ==========================================================================
+/// log(n!) in double-double: from the exact n! for n<=20, lgamma_dd beyond
+inline Math::Kernels::DD _log_factorial_dd_(const unsigned short n) {
+  if (n <= 20) {
+    unsigned long long f = 1;
+    for (unsigned short i = 2; i <= n; ++i) {
+      f *= i;
+    }
+    const unsigned long long h = (unsigned long long)double(f);
+    const Math::Kernels::DD x = {double(f),
+                                 f < h ? -double(h - f) : double(f - h)};
+    return Math::Kernels::log_dd(x);
+  }
+  const Math::Kernels::DD x = {n + 1.0, 0};
+  return Math::Kernels::lgamma_dd(x);
+}
+/// log C(n,k) in double-double for C(n,k) beyond unsigned long long
+inline Math::Kernels::DD _log_choose_dd_(const unsigned short n,
+                                         const unsigned short k) {
+  return _log_factorial_dd_(n) - _log_factorial_dd_(k) -
+         _log_factorial_dd_(n - k);
+}
+/// the double-double x rounded to long double
+inline long double _long_double_(const Math::Kernels::DD &x) {
+  return (long double)x.hi + x.lo;
+}
+/// exp of the double-double x in long double
+inline long double _exp_long_double_(const Math::Kernels::DD &x) {
+  return std::exp((long double)x.hi) * (1 + (long double)x.lo);
+}
+// ==========================================================================
+inline long double _choose_as_(const unsigned short n, const unsigned short k,
+                               As<long double>) {
+  const unsigned long long c = _choose_ull_(n, k);
+  return s_ullmax != c ? c : _exp_long_double_(_log_choose_dd_(n, k));
+}
+inline long double _log_choose_as_(const unsigned short n,
+                                   const unsigned short k, As<long double>) {
+  if (0 == k || k >= n) {
+    return 0;
+  }
+  const unsigned long long c = _choose_ull_(n, k);
+  return s_ullmax != c ? std::log((long double)c)
+                       : _long_double_(_log_choose_dd_(n, k));
+}
+inline long double _log_factorial_as_(const unsigned short n,
+                                      As<long double>) {
+  return _long_double_(_log_factorial_dd_(n));
+}
+inline long double _gen_choose_as_(const long double a, const unsigned short k,
+                                   As<long double>) {
+  // a = hi + lo exactly
+  const double hi = double(a);
+  const Math::Kernels::DD ad = {hi, double(a - hi)};
+  if (k <= s_gen_choose_kmax || s_gen_choose_amax <= std::abs(hi)) {
+    // the product beyond s_gen_choose_amax: it overflows double, not the
+    // exponent range of long double
+    int e = 0;
+    return std::ldexp(_long_double_(_gen_choose_product_(ad, k, e)), e);
+  }
+  int sign = 0;
+  const Math::Kernels::DD l = _gen_choose_log_(ad, k, sign);
+  return 0 == sign ? 0 : sign * _exp_long_double_(l);
+}
+// ==========================================================================
+/** the leading 128 bits m of b = m*2^e, rounded to odd: the dropped bits
+ *  are kept as the lowest bit (sticky), so that FLOAT128(m) is correctly
+ *  rounded
+ */
+inline Math::UINT128 _top128_(const Math::BigUInt &b, std::size_t &e) {
+  const std::vector<Math::BigUInt::Limb> &l = b.limbs();
+  const std::size_t bits = b.bits();
+  e = bits > 128 ? bits - 128 : 0;
+  const std::size_t w = e / 64;
+  const unsigned int s = e % 64;
+  Math::UINT128 m = 0;
+  for (std::size_t i = w; i < l.size() && i < w + 3; ++i) {
+    const std::size_t pos = 64 * (i - w);
+    if (0 == pos) {
+      m |= Math::UINT128(l[i]) >> s;
+    } else if (pos - s < 128) {
+      m |= Math::UINT128(l[i]) << (pos - s);
+    }
+  }
+  bool sticky = 0 != s && 0 != l[w] << (64 - s);
+  for (std::size_t i = 0; i < w && !sticky; ++i) {
+    sticky = 0 != l[i];
+  }
+  return sticky ? m | 1 : m;
+}
+// ==========================================================================
+#ifdef LHCBMATH_FLOAT128
+// ==========================================================================
+// FLOAT128: the exact integers rounded once; the arithmetic is emulated
+// by the compiler runtime, no libquadmath is needed
+// ==========================================================================
+typedef Math::FLOAT128 Quad;
+// ==========================================================================
+/// the sum of three doubles in FLOAT128
+inline Quad _quad_(const double a, const double b, const double c) {
+  return Quad(a) + Quad(b) + Quad(c);
+}
+/// log(2) in FLOAT128
+inline Quad _ln2_quad_() {
+  return _quad_(0.69314718055994529, 2.3190468138462996e-17,
+                5.7777898331617076e-34);
+}
+// ==========================================================================
+/// log(x) in FLOAT128 for x>0 within the range of double
+inline Quad _log_quad_(const Quad x) {
+  int e = 0;
+  std::frexp(double(x), &e);
+  Quad m = x * Quad(std::ldexp(1.0, -e));
+  if (m < Quad(0.70710678118654757)) {
+    m *= 2;
+    --e;
+  }
+  // 2*atanh(s), |s|<0.172: z^23 is below 1e-35
+  const Quad s = (m - 1) / (m + 1);
+  const Quad z = s * s;
+  Quad t = 0;
+  for (int j = 23; 0 <= j; --j) {
+    t = 1 / Quad(2 * j + 1) + z * t;
+  }
+  return e * _ln2_quad_() + 2 * s * t;
+}
+// ==========================================================================
+/// x*2^e
+inline Quad _scale_quad_(Quad x, std::size_t e) {
+  for (; e >= 1000; e -= 1000) {
+    x *= Quad(std::ldexp(1.0, 1000));
+  }
+  return x * Quad(std::ldexp(1.0, int(e)));
+}
+// ==========================================================================
+inline Quad _choose_as_(const unsigned short n, const unsigned short k,
+                        As<Quad>) {
+  const unsigned long long c = _choose_ull_(n, k);
+  if (s_ullmax != c) {
+    return c;
+  }
+  std::size_t e = 0;
+  const Math::UINT128 m = _top128_(Math::choose_exact(n, k), e);
+  return _scale_quad_(Quad(m), e);
+}
+inline Quad _log_choose_as_(const unsigned short n, const unsigned short k,
+                            As<Quad>) {
+  if (0 == k || k >= n) {
+    return 0;
+  }
+  const unsigned long long c = _choose_ull_(n, k);
+  if (s_ullmax != c) {
+    return _log_quad_(Quad(c));
+  }
+  std::size_t e = 0;
+  const Math::UINT128 m = _top128_(Math::choose_exact(n, k), e);
+  return _log_quad_(Quad(m)) + Quad(e) * _ln2_quad_();
+}
+inline Quad _log_factorial_as_(const unsigned short n, As<Quad>) {
+  if (n <= 34) {
+    // n! fits into 128 bits
+    Math::UINT128 f = 1;
+    for (unsigned short i = 2; i <= n; ++i) {
+      f *= i;
+    }
+    return _log_quad_(Quad(f));
+  }
+  // Stirling series, x>=36: the first omitted term is below 1e-35
+  const double num[12] = {1, -1, 1,       -1,      1,     -691,
+                          1, -3617, 43867, -174611, 77683, -236364091};
+  const double den[12] = {12,     360,    1260,   1680,   1188, 360360,
+                          156,    122400, 244188, 125400, 5796, 1506960};
+  const Quad x = n + 1;
+  const Quad y = 1 / x;
+  Quad t = 0;
+  for (int j = 11; 0 <= j; --j) {
+    t = Quad(num[j]) / Quad(den[j]) + y * y * t;
+  }
+  // log(2*pi)/2
+  const Quad h = _quad_(0.91893853320467278, -3.8782941580672414e-17,
+                        -1.3481509610710651e-33);
+  return (x - 0.5) * _log_quad_(x) - x + h + y * t;
+}
+/// the product in FLOAT128, relative error below k*2^-112
+inline Quad _gen_choose_as_(const Quad a, const unsigned short k, As<Quad>) {
+  Quad r = 1;
+  for (unsigned short j = 0; j < k; ++j) {
+    r = r * (a - j) / (j + 1);
+  }
+  return r;
+}
+// ==========================================================================
+#endif // LHCBMATH_FLOAT128
+// ==========================================================================
+/// the batches of the other types: one entry at a time
+template <class T>
+void _choose_as_(const unsigned short *n, const unsigned short *k, T *out,
+                 const std::size_t size, As<T> tag) {
+  for (std::size_t i = 0; i < size; ++i) {
+    out[i] = _choose_as_(n[i], k[i], tag);
+  }
+}
+template <class T>
+void _log_choose_as_(const unsigned short *n, const unsigned short *k, T *out,
+                     const std::size_t size, As<T> tag) {
+  for (std::size_t i = 0; i < size; ++i) {
+    out[i] = _log_choose_as_(n[i], k[i], tag);
+  }
+}
+// ==========================================================================
+// The accuracy tiers of Math::choose_double and Math::log_choose
+// ==========================================================================
+/// log(x!) - log(2*pi)/2 from the Stirling series with two terms, r=1/x
+LHCBMATH_KERNEL double _stirling_(const double x, const double lx,
+                                  const double r) {
+  return (x + 0.5) * lx - x + r * (1.0 / 12 - r * r / 360);
+}
+/** log C(n,k) from the Stirling series for n>Pascal::nmax, k<=n: the
+ *  truncation error is below 1/(1260*16^5) = 7.6e-10 per factorial.
+ *  Only the smaller j of k and n-k can be below 16: then log(j!) is the
+ *  log of the exact j!, built without branches (a table lookup would be
+ *  a gather, which the clones do not emit). The three reciprocals come
+ *  from one division, n*(n-j)*j < 2^53 is exact.
+ */
+LHCBMATH_KERNEL double _log_choose_stirling_(const unsigned short n,
+                                         const unsigned short k) {
+  using Math::Kernels::_bits_;
+  using Math::Kernels::_double_;
+  const unsigned short j = 2 * k < n ? k : n - k;
+  const std::uint64_t small = -std::uint64_t(j < 16);
+  double f = 1;
+  LHCBMATH_UNROLL(16)
+  for (int i = 2; i < 16; ++i) {
+    f *= i <= j ? i : 1;
+  } // exact: 15! < 2^53
+  const double x = n;
+  const double y = n - j;
+  const double z = j < 16 ? 16 : j;
+  const double lz =
+      Math::Kernels::log(_double_((_bits_(f) & small) | (_bits_(z) & ~small)));
+  const double p = 1 / (x * y * z);
+  const double sz = _stirling_(z, lz, x * y * p) + 0.91893853320467278;
+  // select on the bits: a select of doubles may become a branch
+  return _stirling_(x, Math::Kernels::log(x), y * z * p) -
+         _stirling_(y, Math::Kernels::log(y), x * z * p) -
+         _double_((_bits_(lz) & small) | (_bits_(sz) & ~small));
+}
+/// C(n,k) fits into unsigned long long (or k>n): the standard tier is exact
+inline bool _fits_(const unsigned short n, const unsigned short k) {
+  return k > n || n <= Pascal::nmax || s_pascal.fits(n, 2 * k < n ? k : n - k);
+}
+/// C(n,k) from the Stirling series, exact integers where they fit
+inline double _choose_stirling_(const unsigned short n,
+                                const unsigned short k) {
+  return _fits_(n, k) ? _choose_double_(n, k)
+                      : Math::Kernels::exp(_log_choose_stirling_(n, k));
+}
+/// log C(n,k) from the Stirling series, exact integers where they fit
+inline double _log_choose_stirling_scalar_(const unsigned short n,
+                                           const unsigned short k) {
+  return _fits_(n, k) ? _log_choose_(n, k) : _log_choose_stirling_(n, k);
+}
+// ==========================================================================
+/// out[i] = log C(n[i],k[i]) for i<s_block, overwritten where _fits_
+LHCBMATH_TARGET_CLONES
+void _log_choose_stirling_block_(const unsigned short *n,
+                                 const unsigned short *k, double *out) {
+  for (std::size_t i = 0; i < s_block; ++i) {
+    out[i] = _log_choose_stirling_(n[i], k[i]);
+  }
+}
+/// out[i] = C(n[i],k[i]) for i<s_block, overwritten where _fits_
+LHCBMATH_TARGET_CLONES
+void _choose_stirling_block_(const unsigned short *n, const unsigned short *k,
+                             double *out) {
+  for (std::size_t i = 0; i < s_block; ++i) {
+    out[i] = Math::Kernels::exp(_log_choose_stirling_(n[i], k[i]));
+  }
+}
+/// apply the block kernel to the arrays, the last block padded with zeros
+template <class KERNEL>
+void _stirling_blocks_(const unsigned short *n, const unsigned short *k,
+                       double *out, const std::size_t size, KERNEL kernel) {
+  unsigned short nb[s_block];
+  unsigned short kb[s_block];
+  double res[s_block];
+  for (std::size_t i0 = 0; i0 < size; i0 += s_block) {
+    const std::size_t m = std::min(size - i0, s_block);
+    std::fill(nb + m, nb + s_block, 0);
+    std::fill(kb + m, kb + s_block, 0);
+    std::copy(n + i0, n + i0 + m, nb);
+    std::copy(k + i0, k + i0 + m, kb);
+    kernel(nb, kb, res);
+    std::copy(res, res + m, out + i0);
+  }
+}
+// ==========================================================================
+/// the 64-bit integer u as double-double, exactly
+inline Math::Kernels::DD _dd_(const unsigned long long u) {
+  return Math::Kernels::fast_two_sum(double(u >> 11 << 11), double(u & 2047));
+}
+/** log(m*2^e) in double-double rounded once: correctly rounded unless
+ *  it lies within 1e-31 (relative) of the midpoint of two doubles
+ */
+inline double _log_rounded_(const Math::UINT128 m, const std::size_t e) {
+  using Math::Kernels::DD;
+  const DD x = _dd_((unsigned long long)(m >> 64)) * 18446744073709551616.0 +
+               _dd_((unsigned long long)m);
+  const DD ln2 = {0.69314718055994529, 2.3190468138462996e-17};
+  return (Math::Kernels::log_dd(x) + ln2 * double(e)).hi;
+}
+/// C(n,k) correctly rounded
+inline double _choose_rounded_(const unsigned short n, const unsigned short k) {
+  const unsigned long long c = _choose_ull_(n, k);
+  return s_ullmax != c ? c : Math::choose_exact(n, k).to_double();
+}
+/// log C(n,k) correctly rounded, see _log_rounded_
+inline double _log_choose_rounded_(const unsigned short n,
+                                   const unsigned short k) {
+  if (0 == k || k >= n) {
+    return 0;
+  }
+  const unsigned long long c = _choose_ull_(n, k);
+  std::size_t e = 0;
+  const Math::UINT128 m =
+      s_ullmax != c ? c : _top128_(Math::choose_exact(n, k), e);
+  return _log_rounded_(m, e);
+}
+// ==========================================================================
+// multinomial coefficients
+// ==========================================================================
+/** C(s,k) with saturation for 64-bit s, k<=s: see _choose_ull_ for
+ *  s<=65535, beyond it the product c = c*(s-i)/(i+1) = C(s,i+1)
+ *  saturates within 64 steps
+ */
+inline unsigned long long _choose_ull64_(const std::uint64_t s,
+                                         const std::uint64_t k) {
+  if (s <= std::numeric_limits<unsigned short>::max()) {
+    return _choose_ull_(s, k);
+  }
+  const std::uint64_t j = k < s - k ? k : s - k;
+  Math::UINT128 c = 1;
+  for (std::uint64_t i = 0; i < j; ++i) {
+    c = c * (s - i) / (i + 1);
+    if (s_ullmax <= c) {
+      return s_ullmax;
+    }
+  }
+  return c;
+}
+// ==========================================================================
+/** the multinomial coefficient with saturation, see Math::multinomial:
+ *  the product of C(k1+...+ki,ki), O(m) steps
+ */
+inline unsigned long long _multinomial_ull_(const unsigned short *ks,
+                                            const std::size_t m) {
+  std::uint64_t s = 0;
   unsigned long long r = 1;
-  for (unsigned short d = 1; d <= k; ++d, --n) {
-    if (r > s_ullmax / n * d) {
+  for (std::size_t i = 0; i < m; ++i) {
+    s += ks[i];
+    const Math::UINT128 p = (Math::UINT128)r * _choose_ull64_(s, ks[i]);
+    if (s_ullmax <= p) {
       return s_ullmax;
-    } //  RETURN
-    // r *= n ;
-    // r /= d ;
-    r = (r / d) * n + (r % d) * n / d;
+    }
+    r = p;
   }
   return r;
 }
 // ==========================================================================
-/// zero for doubles
-const Zero<double> s_zero{}; // zero for doubles
+/// log(n!) for 64-bit n: the table of log(n!), the Stirling series beyond
+inline double _log_factorial64_(const std::uint64_t n) {
+  if (n <= std::numeric_limits<unsigned short>::max()) {
+    return _log_factorials_()(n);
+  }
+  const double x = double(n);
+  return (x + 0.5) * Math::Kernels::log(x) - x + 0.91893853320467278 +
+         _stirling_delta_(n);
+}
+/// log(n!) - sum log(ki!) beyond unsigned long long, see Math::log_multinomial
+inline double _log_multinomial_table_(const unsigned short *ks,
+                                      const std::size_t m) {
+  const LogFactorials &lf = _log_factorials_();
+  std::uint64_t n = 0;
+  double s = 0;
+  for (std::size_t i = 0; i < m; ++i) {
+    n += ks[i];
+    s += lf(ks[i]);
+  }
+  return _log_factorial64_(n) - s;
+}
+/// log of the multinomial coefficient, see Math::log_multinomial
+inline double _log_multinomial_(const unsigned short *ks,
+                                const std::size_t m) {
+  const unsigned long long r = _multinomial_ull_(ks, m);
+  return s_ullmax != r ? Math::Kernels::log(r)
+                       : _log_multinomial_table_(ks, m);
+}
+// ==========================================================================
+// the grouped batch of choose_double
+// ==========================================================================
+/// the chunk of the grouped batch: its scratch arrays stay in L2
+const std::size_t s_chunk = 4096;
+/// the regimes of C(n,k): k>n, the table, the exact integer, log(n!)
+const unsigned int s_regimes = 4;
+// ==========================================================================
+/** The scratch arrays of one chunk of m queries:
+ *  the distinct keys n<<16|k, the distinct index of each query,
+ *  the regime of each key and the keys sorted by regime, and the
+ *  open-addressing hash table of the keys (distinct index + 1, 0 if empty)
+ */
+struct GroupedScratch {
+  // ========================================================================
+  explicit GroupedScratch(const std::size_t m)
+      : keys(m), unique(m), regime(m), order(m), value(m), bits(1) {
+    while ((std::size_t(1) << bits) < 2 * m) {
+      ++bits;
+    }
+    slots.resize(std::size_t(1) << bits);
+  }
+  // ========================================================================
+  std::vector<std::uint32_t> keys;
+  std::vector<std::uint32_t> unique;
+  std::vector<unsigned char> regime;
+  std::vector<std::uint32_t> order;
+  std::vector<double> value;
+  std::vector<std::uint32_t> slots;
+  unsigned int bits;
+  // ========================================================================
+};
+// ==========================================================================
+/// collapse the repeated (n,k) of the chunk: the number of distinct keys
+inline std::size_t _dedup_(const unsigned short *n, const unsigned short *k,
+                           const std::size_t m, GroupedScratch &s) {
+  std::fill(s.slots.begin(), s.slots.end(), 0u);
+  const std::uint32_t mask = (std::uint32_t(1) << s.bits) - 1;
+  std::size_t nu = 0;
+  for (std::size_t i = 0; i < m; ++i) {
+    const std::uint32_t key = std::uint32_t(n[i]) << 16 | k[i];
+    std::uint32_t h = (key * 0x9E3779B1u) >> (32 - s.bits);
+    for (;; h = (h + 1) & mask) {
+      const std::uint32_t u = s.slots[h];
+      if (0 == u) {
+        s.slots[h] = nu + 1;
+        s.keys[nu] = key;
+        s.unique[i] = nu++;
+        break;
+      } else if (key == s.keys[u - 1]) {
+        s.unique[i] = u - 1;
+        break;
+      }
+    }
+  }
+  return nu;
+}
+// ==========================================================================
+/** sort the distinct keys by regime: a counting sort without branches,
+ *  first[r] is the start of the regime r in s.order
+ */
+inline void _sort_regimes_(const std::size_t nu, GroupedScratch &s,
+                           std::size_t *first) {
+  std::size_t count[s_regimes] = {0, 0, 0, 0};
+  for (std::size_t u = 0; u < nu; ++u) {
+    const unsigned short n = s.keys[u] >> 16;
+    const unsigned short k = s.keys[u] & 0xFFFF;
+    const unsigned short k1 = 2 * k < n ? k : n - k;
+    const unsigned int r = k > n ? 0
+                           : n <= Pascal::nmax   ? 1
+                           : s_pascal.fits(n, k1) ? 2
+                                                  : 3;
+    s.regime[u] = r;
+    ++count[r];
+  }
+  first[0] = 0;
+  for (unsigned int r = 1; r <= s_regimes; ++r) {
+    first[r] = first[r - 1] + count[r - 1];
+  }
+  std::size_t next[s_regimes] = {first[0], first[1], first[2], first[3]};
+  for (std::size_t u = 0; u < nu; ++u) {
+    s.order[next[s.regime[u]]++] = u;
+  }
+}
+// ==========================================================================
+/// C(n,k) of the distinct keys, one regime after the other
+inline void _choose_regimes_(const std::size_t *first, GroupedScratch &s) {
+  const std::uint32_t *o = s.order.data();
+  double *v = s.value.data();
+  for (std::size_t j = first[0]; j < first[1]; ++j) {
+    v[o[j]] = 0;
+  }
+  for (std::size_t j = first[1]; j < first[2]; ++j) {
+    const unsigned short n = s.keys[o[j]] >> 16;
+    const unsigned short k = s.keys[o[j]] & 0xFFFF;
+    v[o[j]] = s_pascal(n, 2 * k < n ? k : n - k);
+  }
+  for (std::size_t j = first[2]; j < first[3]; ++j) {
+    const unsigned short n = s.keys[o[j]] >> 16;
+    const unsigned short k = s.keys[o[j]] & 0xFFFF;
+    v[o[j]] = _choose_exact_(n, 2 * k < n ? k : n - k);
+  }
+  if (first[3] == first[4]) {
+    return;
+  }
+  const LogFactorials &lf = _log_factorials_();
+  double arg[s_block];
+  double res[s_block];
+  for (std::size_t j0 = first[3]; j0 < first[4]; j0 += s_block) {
+    const std::size_t j1 = std::min(first[4], j0 + s_block);
+    std::fill(arg, arg + s_block, 0.0);
+    for (std::size_t j = j0; j < j1; ++j) {
+      const unsigned short n = s.keys[o[j]] >> 16;
+      const unsigned short k = s.keys[o[j]] & 0xFFFF;
+      arg[j - j0] = lf(n) - lf(n - k) - lf(k);
+    }
+    _exp_block_(arg, res);
+    for (std::size_t j = j0; j < j1; ++j) {
+      v[o[j]] = res[j - j0];
+    }
+  }
+}
 // ==========================================================================
 }
 // ============================================================================
@@ -71,7 +844,16 @@ const Zero<double> s_zero{}; // zero for doubles
 // ============================================================================
 unsigned long long Math::choose(const unsigned short n,
                                 const unsigned short k) {
-  return _choose_(n, k);
+  return Math::Inline::choose(n, k);
+}
+// ============================================================================
+/*  calculate the binomial coefficient C(n,k) = n!/((n-k)!*k!) in 128 bits
+ *  the result is exact for all n,k<=131
+ *  @warning In case of overflow the largest Math::UINT128 is returned
+ */
+// ============================================================================
+Math::UINT128 Math::choose128(const unsigned short n, const unsigned short k) {
+  return Math::Inline::choose128(n, k);
 }
 // ============================================================================
 /** calculate the binomial coefficient C(k,n) = n!/((n-k)!*k!)
@@ -80,36 +862,7 @@ unsigned long long Math::choose(const unsigned short n,
  */
 // ============================================================================
 double Math::choose_double(const unsigned short n, const unsigned short k) {
-  //
-  if (k > n) {
-    return 0;
-  } else if (0 == k || n == k) {
-    return 1;
-  } else if (n < s_digits) {
-    return _choose_(n, k);
-  } else if (n <= 67) {
-    return _choose_(n, k);
-  }
-  //
-  const unsigned short k1 = 2 * k < n ? k : n - k;
-  if (k1 * std::log2(M_E * n / k1) < 63) {
-    return _choose_(n, k);
-  }
-  //
-  long double a = std::lgamma((long double)n + 1);
-  if (a < s_emax) {
-    return _choose_(n, k);
-  }
-  a -= std::lgamma((long double)n - k + 1);
-  if (a < s_emax) {
-    return _choose_(n, k);
-  }
-  a -= std::lgamma((long double)k + 1);
-  if (a < s_emax) {
-    return _choose_(n, k);
-  }
-  //
-  return std::exp(a);
+  return Math::Inline::choose_double(n, k);
 }
 // ============================================================================
 /*  calculate the generalized binomial coefficient C(a,n)
@@ -119,24 +872,7 @@ double Math::choose_double(const unsigned short n, const unsigned short k) {
  */
 // ============================================================================
 double Math::gen_choose(const double a, const unsigned short k) {
-  //
-  if (0 == k) {
-    return 1;
-  } else if (1 == k) {
-    return a;
-  } else if (s_zero(a)) {
-    return 0;
-  }
-  //
-  long double r = 1;
-  long double b = a;
-  for (unsigned short d = k; 0 < d; --d) {
-    // if ( s_zero( b ) ) { return 0 ; }  // RETURN
-    r *= b;
-    r /= d;
-    b -= 1;
-  }
-  return r;
+  return Math::Inline::gen_choose(a, k);
 }
 // ============================================================================
 /*  calculate the generalized binomial coefficient C(n/2,k)
@@ -146,25 +882,7 @@ double Math::gen_choose(const double a, const unsigned short k) {
  */
 // ============================================================================
 double Math::choose_half(const int n, const unsigned short k) {
-  if (0 == k) {
-    return 1;
-  } else if (0 < n && 0 == n % 2) {
-    return choose(n * 2, k);
-  } else if (1 == k) {
-    return 0.5 * n;
-  } // attention!
-  else if (0 == n) {
-    return 0;
-  }
-  //
-  long double r = 1;
-  int N = n;
-  for (unsigned short d = k; 0 < d; --d) {
-    r *= N;
-    r /= d;
-    N -= 2; // ATTENTION
-  }
-  return k < 63 ? r / pow(2L, k) : r / pow(2.0L, k);
+  return Math::Inline::choose_half(n, k);
 }
 // ============================================================================
 /*  calculate the logarithm of binomial coefficient
@@ -174,22 +892,482 @@ double Math::choose_half(const int n, const unsigned short k) {
  */
 // ============================================================================
 double Math::log_choose(const unsigned short n, const unsigned short k) {
-  if (k <= 1 || k >= n) {
-    return 0;
-  } //
-  else if (n <= 67) {
-    return std::log((long double)_choose_(n, k));
+  return Math::Inline::log_choose(n, k);
+}
+// ============================================================================
+/*  calculate the logarithm of binomial coefficient for 64-bit n
+ *  in O(1) from the Stirling series
+ */
+// ============================================================================
+double Math::log_choose64(const std::uint64_t n, const std::uint64_t k) {
+  return Math::Inline::log_choose64(n, k);
+}
+
+// ============================================================================
+/*  calculate the multinomial coefficient (k1+...+km)!/(k1!*...*km!)
+ *  with saturation
+ */
+// ============================================================================
+unsigned long long Math::multinomial(const unsigned short *ks,
+                                     const std::size_t m) {
+  return _multinomial_ull_(ks, m);
+}
+// ============================================================================
+/*  calculate the logarithm of multinomial coefficient
+ */
+// ============================================================================
+double Math::log_multinomial(const unsigned short *ks, const std::size_t m) {
+  return _log_multinomial_(ks, m);
+}
+// ============================================================================
+/*  get the logarithm of factorial log(n!)
+ *  the value is taken from the table built at the first call
+ */
+// ============================================================================
+double Math::log_factorial(const unsigned short n) {
+  return Math::Inline::log_factorial(n);
+}
+// ============================================================================
+/*  fill the row of binomial coefficients out[k] = C(n,k), k=0..n
+ */
+// ============================================================================
+std::size_t Math::choose_row(const unsigned short n, unsigned long long *out) {
+  std::size_t nsat = 0;
+  for (unsigned short k = _choose_row_exact_(n, out); 2 * k <= n; ++k) {
+    out[k] = s_ullmax;
+    nsat += 2 * k < n ? 2 : 1;
+  }
+  _mirror_row_(n, out);
+  return nsat;
+}
+// ============================================================================
+/*  fill the row of binomial coefficients out[k] = C(n,k), k=0..n
+ */
+// ============================================================================
+void Math::choose_double_row(const unsigned short n, double *out) {
+  unsigned short k = _choose_row_exact_(n, out);
+  if (2 * k <= n) {
+    // continue with the multiplicative recurrence in double
+    double c = out[k - 1];
+    for (; 2 * k <= n; ++k) {
+      c = c / k * (n - k + 1);
+      out[k] = c;
+    }
   }
+  _mirror_row_(n, out);
+}
+// ============================================================================
+/*  fill the row of logarithms of binomial coefficients
+ *  out[k] = log C(n,k), k=0..n
+ */
+// ============================================================================
+void Math::log_choose_row(const unsigned short n, double *out) {
+  choose_double_row(n, out);
+  // switch to log(n!) once C(n,k) overflows double
+  const LogFactorials &lf = _log_factorials_();
+  double buffer[s_block];
+  for (unsigned short k0 = 0; 2 * k0 <= n; k0 += s_block) {
+    const unsigned short k1 = std::min(n / 2 + 1, k0 + (int)s_block);
+    std::fill(std::copy(out + k0, out + k1, buffer), buffer + s_block, 1.0);
+    _log_block_(buffer, buffer);
+    for (unsigned short k = k0; k < k1; ++k) {
+      out[k] = std::isinf(out[k]) ? lf(n) - lf(n - k) - lf(k) : buffer[k - k0];
+    }
+  }
+  _mirror_row_(n, out);
+}
+// ============================================================================
+/*  fill the row of generalized binomial coefficients out[k] = C(a,k)
+ *  for k=0..K
+ */
+// ============================================================================
+void Math::gen_choose_row(const double a, const unsigned short K,
+                          double *out) {
+  const Math::Kernels::DD ad = {a, 0};
+  Math::Kernels::DD r = {1, 0};
+  int e = 0;
+  out[0] = 1;
+  for (unsigned short k = 0; k < K; ++k) {
+    r = _gen_choose_step_(r, e, ad, k);
+    out[k + 1] = 0 == e ? r.hi : std::ldexp(r.hi, e);
+  }
+}
+// ============================================================================
+/*  fill the row of generalized binomial coefficients out[k] = C(n/2,k)
+ *  for k=0..K
+ */
+// ============================================================================
+void Math::choose_half_row(const int n, const unsigned short K, double *out) {
+  gen_choose_row(0.5 * n, K, out);
+}
+// ============================================================================
+// BinomialCursor
+// ============================================================================
+Math::BinomialCursor::BinomialCursor(const unsigned short n,
+                                     const unsigned short k)
+    : m_n(n), m_k(k), m_repr(Exact), m_exact(0), m_value(0), m_steps(0),
+      m_limit(0) {
+  reset(n, k);
+}
+// ============================================================================
+void Math::BinomialCursor::reset(const unsigned short n,
+                                 const unsigned short k) {
+  m_n = n;
+  m_k = k;
+  m_steps = 0;
+  m_limit = 0;
   //
   const unsigned short k1 = 2 * k < n ? k : n - k;
-  if (k1 * std::log2(M_E * n / k1) < 63) {
-    return std::log((long double)_choose_(n, k));
+  if (k > n || s_pascal.fits(n, k1)) {
+    m_repr = Exact;
+    m_exact = _choose_ull_(n, k);
+    return;
   }
   //
-  return std::lgamma((long double)(n + 1)) - std::lgamma((long double)(k + 1)) -
-         std::lgamma((long double)(n - k + 1));
+  const LogFactorials &lf = _log_factorials_();
+  m_value = lf(n) - lf(n - k) - lf(k);
+  m_repr = m_value < s_logmax ? Double : Log;
+  if (Double == m_repr) {
+    m_value = Math::Kernels::exp(m_value);
+  }
+  // the recomputed value is precise to ~ epsilon*log(n!),
+  // each step adds ~ 2*epsilon
+  m_limit = 64 + (unsigned int)(0.5 * lf(n));
 }
-
+// ============================================================================
+void Math::BinomialCursor::step(const unsigned short n, const unsigned short k,
+                                const unsigned short num,
+                                const unsigned short den) {
+  // trivial values at either end: no ratio to apply
+  if (0 == k || n <= k || 0 == m_k || m_n <= m_k) {
+    return reset(n, k);
+  }
+  //
+  const bool fits = s_pascal.fits(n, 2 * k < n ? k : n - k);
+  if (Exact == m_repr && fits) {
+    m_exact = (unsigned long long)((Math::UINT128)m_exact * num / den);
+    m_n = n;
+    m_k = k;
+    return;
+  } else if (Exact == m_repr || fits || m_limit <= ++m_steps) {
+    return reset(n, k);
+  }
+  //
+  m_n = n;
+  m_k = k;
+  if (Double == m_repr) {
+    m_value = m_value / den * num;
+    if (std::isinf(m_value)) {
+      reset(n, k);
+    }
+  } else {
+    m_value += Math::Kernels::log((double)num / den);
+    if (m_value < s_logmax) {
+      reset(n, k);
+    }
+  }
+}
+// ============================================================================
+Math::BinomialCursor &Math::BinomialCursor::next_n() {
+  step(m_n + 1, m_k, m_n + 1, m_n + 1 - m_k);
+  return *this;
+}
+// ============================================================================
+Math::BinomialCursor &Math::BinomialCursor::prev_n() {
+  step(m_n - 1, m_k, m_n - m_k, m_n);
+  return *this;
+}
+// ============================================================================
+Math::BinomialCursor &Math::BinomialCursor::next_k() {
+  step(m_n, m_k + 1, m_n - m_k, m_k + 1);
+  return *this;
+}
+// ============================================================================
+Math::BinomialCursor &Math::BinomialCursor::prev_k() {
+  step(m_n, m_k - 1, m_k, m_n - m_k + 1);
+  return *this;
+}
+// ============================================================================
+unsigned long long Math::BinomialCursor::exact() const {
+  return Exact == m_repr ? m_exact : s_ullmax;
+}
+// ============================================================================
+double Math::BinomialCursor::value() const {
+  return Exact == m_repr
+             ? m_exact
+             : Double == m_repr ? m_value : Math::Kernels::exp(m_value);
+}
+// ============================================================================
+double Math::BinomialCursor::log_value() const {
+  return Exact == m_repr
+             ? Math::Kernels::log(m_exact)
+             : Double == m_repr ? Math::Kernels::log(m_value) : m_value;
+}
+// ============================================================================
+/*  calculate binomial coefficients C(n[i],k[i]) for i<size
+ */
+// ============================================================================
+std::size_t Math::choose(const unsigned short *n, const unsigned short *k,
+                         unsigned long long *out, const std::size_t size,
+                         std::uint64_t *saturated) {
+  std::size_t nsat = 0;
+  for (std::size_t i0 = 0; i0 < size; i0 += s_block) {
+    const std::size_t i1 = std::min(size, i0 + s_block);
+    // table lookup for all entries: no branches
+    for (std::size_t i = i0; i < i1; ++i) {
+      out[i] = _choose_small_(n[i], k[i]);
+    }
+    // fix large n and collect the saturation mask
+    std::uint64_t mask = 0;
+    for (std::size_t i = i0; i < i1; ++i) {
+      if (Pascal::nmax < n[i]) {
+        out[i] = _choose_ull_(n[i], k[i]);
+      }
+      mask |= std::uint64_t(s_ullmax == out[i]) << (i - i0);
+    }
+    for (std::uint64_t m = mask; m; m &= m - 1) {
+      ++nsat;
+    }
+    if (saturated) {
+      saturated[i0 / s_block] = mask;
+    }
+  }
+  return nsat;
+}
+// ============================================================================
+/*  calculate binomial coefficients C(n[i],k[i]) for i<size as doubles
+ */
+// ============================================================================
+void Math::choose_double(const unsigned short *n, const unsigned short *k,
+                         double *out, const std::size_t size) {
+  Binomial<double>::choose(n, k, out, size);
+}
+// ============================================================================
+/*  calculate binomial coefficients C(n[i],k[i]) for i<size as doubles,
+ *  each distinct (n,k) once, grouped by regime
+ */
+// ============================================================================
+void Math::choose_double_grouped(const unsigned short *n,
+                                 const unsigned short *k, double *out,
+                                 const std::size_t size) {
+  GroupedScratch s(std::min(size, s_chunk));
+  std::size_t first[s_regimes + 1];
+  for (std::size_t i0 = 0; i0 < size; i0 += s_chunk) {
+    const std::size_t m = std::min(size - i0, s_chunk);
+    const std::size_t nu = _dedup_(n + i0, k + i0, m, s);
+    _sort_regimes_(nu, s, first);
+    _choose_regimes_(first, s);
+    for (std::size_t i = 0; i < m; ++i) {
+      out[i0 + i] = s.value[s.unique[i]];
+    }
+  }
+}
+// ============================================================================
+/*  calculate logarithms of binomial coefficients log C(n[i],k[i]) for i<size
+ */
+// ============================================================================
+void Math::log_choose(const unsigned short *n, const unsigned short *k,
+                      double *out, const std::size_t size) {
+  Binomial<double>::log_choose(n, k, out, size);
+}
+// ============================================================================
+/*  calculate the multinomial coefficients of the count vectors
+ *  ks[i*m],...,ks[i*m+m-1] for i<size
+ */
+// ============================================================================
+std::size_t Math::multinomial(const unsigned short *ks, const std::size_t m,
+                              unsigned long long *out, const std::size_t size,
+                              std::uint64_t *saturated) {
+  std::size_t nsat = 0;
+  for (std::size_t i0 = 0; i0 < size; i0 += s_block) {
+    const std::size_t i1 = std::min(size, i0 + s_block);
+    std::uint64_t mask = 0;
+    for (std::size_t i = i0; i < i1; ++i) {
+      out[i] = _multinomial_ull_(ks + i * m, m);
+      mask |= std::uint64_t(s_ullmax == out[i]) << (i - i0);
+    }
+    for (std::uint64_t b = mask; b; b &= b - 1) {
+      ++nsat;
+    }
+    if (saturated) {
+      saturated[i0 / s_block] = mask;
+    }
+  }
+  return nsat;
+}
+// ============================================================================
+/*  calculate the logarithms of multinomial coefficients of the count
+ *  vectors ks[i*m],...,ks[i*m+m-1] for i<size
+ */
+// ============================================================================
+void Math::log_multinomial(const unsigned short *ks, const std::size_t m,
+                           double *out, const std::size_t size) {
+  // exact values go through log, one block at a time
+  double arg[s_block];
+  double res[s_block];
+  for (std::size_t i0 = 0; i0 < size; i0 += s_block) {
+    const std::size_t i1 = std::min(size, i0 + s_block);
+    std::uint64_t mask = 0;
+    std::fill(arg, arg + s_block, 1.0);
+    for (std::size_t i = i0; i < i1; ++i) {
+      const unsigned long long r = _multinomial_ull_(ks + i * m, m);
+      if (s_ullmax != r) {
+        arg[i - i0] = r;
+        mask |= std::uint64_t(1) << (i - i0);
+      } else {
+        out[i] = _log_multinomial_table_(ks + i * m, m);
+      }
+    }
+    if (!mask) {
+      continue;
+    }
+    _log_block_(arg, res);
+    for (std::size_t i = i0; i < i1; ++i) {
+      out[i] = mask >> (i - i0) & 1 ? res[i - i0] : out[i];
+    }
+  }
+}
+// ============================================================================
+// The accuracy tiers, see Math::stirling and Math::exact
+// ============================================================================
+double Math::choose_double(const unsigned short n, const unsigned short k,
+                           Math::stirling) {
+  return _choose_stirling_(n, k);
+}
+double Math::choose_double(const unsigned short n, const unsigned short k,
+                           Math::exact) {
+  return _choose_rounded_(n, k);
+}
+double Math::log_choose(const unsigned short n, const unsigned short k,
+                        Math::stirling) {
+  return _log_choose_stirling_scalar_(n, k);
+}
+double Math::log_choose(const unsigned short n, const unsigned short k,
+                        Math::exact) {
+  return _log_choose_rounded_(n, k);
+}
+// ============================================================================
+void Math::choose_double(const unsigned short *n, const unsigned short *k,
+                         double *out, const std::size_t size, Math::stirling) {
+  _stirling_blocks_(n, k, out, size, _choose_stirling_block_);
+  for (std::size_t i = 0; i < size; ++i) {
+    if (_fits_(n[i], k[i])) {
+      out[i] = _choose_double_(n[i], k[i]);
+    }
+  }
+}
+void Math::choose_double(const unsigned short *n, const unsigned short *k,
+                         double *out, const std::size_t size, Math::exact) {
+  for (std::size_t i = 0; i < size; ++i) {
+    out[i] = _choose_rounded_(n[i], k[i]);
+  }
+}
+void Math::log_choose(const unsigned short *n, const unsigned short *k,
+                      double *out, const std::size_t size, Math::stirling) {
+  _stirling_blocks_(n, k, out, size, _log_choose_stirling_block_);
+  for (std::size_t i = 0; i < size; ++i) {
+    if (k[i] >= n[i] || _fits_(n[i], k[i])) {
+      out[i] = _log_choose_(n[i], k[i]);
+    }
+  }
+}
+void Math::log_choose(const unsigned short *n, const unsigned short *k,
+                      double *out, const std::size_t size, Math::exact) {
+  for (std::size_t i = 0; i < size; ++i) {
+    out[i] = _log_choose_rounded_(n[i], k[i]);
+  }
+}
+// ============================================================================
+/*  sum the binomial series of (1+x)^a up to x^K for x[i], i<size
+ */
+// ============================================================================
+void Math::gen_choose_series(const double a, const unsigned short K,
+                             const double *x, double *out,
+                             const std::size_t size) {
+  double arg[s_block];
+  double res[s_block];
+  for (std::size_t i0 = 0; i0 < size; i0 += s_block) {
+    const std::size_t i1 = std::min(size, i0 + s_block);
+    std::fill(std::copy(x + i0, x + i1, arg), arg + s_block, 0.0);
+    _series_block_(a, K, arg, res);
+    std::copy(res, res + (i1 - i0), out + i0);
+  }
+}
+// ============================================================================
+/*  sum the binomial series of (1+x)^(n/2) up to x^K for x[i], i<size
+ */
+// ============================================================================
+void Math::choose_half_series(const int n, const unsigned short K,
+                              const double *x, double *out,
+                              const std::size_t size) {
+  gen_choose_series(0.5 * n, K, x, out, size);
+}
+// ============================================================================
+// Math::Binomial
+// ============================================================================
+template <class T>
+T Math::Binomial<T>::choose(const unsigned short n, const unsigned short k) {
+  return _choose_as_(n, k, As<T>());
+}
+// ============================================================================
+template <class T>
+T Math::Binomial<T>::log_choose(const unsigned short n,
+                                const unsigned short k) {
+  return _log_choose_as_(n, k, As<T>());
+}
+// ============================================================================
+template <class T>
+T Math::Binomial<T>::log_factorial(const unsigned short n) {
+  return _log_factorial_as_(n, As<T>());
+}
+// ============================================================================
+template <class T>
+T Math::Binomial<T>::gen_choose(const T a, const unsigned short k) {
+  if (0 == k) {
+    return 1;
+  } else if (1 == k) {
+    return a;
+  }
+  return _gen_choose_as_(a, k, As<T>());
+}
+// ============================================================================
+template <class T>
+T Math::Binomial<T>::choose_half(const int n, const unsigned short k) {
+  if (0 == k) {
+    return 1;
+  } else if (0 < n && 0 == n % 2 &&
+             n / 2 <= std::numeric_limits<unsigned short>::max()) {
+    return choose(n / 2, k);
+  } else if (1 == k) {
+    return T(0.5 * n);
+  } // attention!
+  else if (0 == n) {
+    return 0;
+  }
+  // n/2 is exact in double
+  return _gen_choose_as_(0.5 * n, k, As<T>());
+}
+// ============================================================================
+template <class T>
+void Math::Binomial<T>::choose(const unsigned short *n,
+                               const unsigned short *k, T *out,
+                               const std::size_t size) {
+  _choose_as_(n, k, out, size, As<T>());
+}
+// ============================================================================
+template <class T>
+void Math::Binomial<T>::log_choose(const unsigned short *n,
+                                   const unsigned short *k, T *out,
+                                   const std::size_t size) {
+  _log_choose_as_(n, k, out, size, As<T>());
+}
+// ============================================================================
+template struct Math::Binomial<float>;
+template struct Math::Binomial<double>;
+template struct Math::Binomial<long double>;
+#ifdef LHCBMATH_FLOAT128
+template struct Math::Binomial<Math::FLOAT128>;
+#endif
 // ============================================================================
 // The END
 // ============================================================================
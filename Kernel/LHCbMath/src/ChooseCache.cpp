@@ -0,0 +1,207 @@
+// ============================================================================
+// Include files
+// ============================================================================
+// STD/STL
+// ============================================================================
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+// ============================================================================
+// local
+// ============================================================================
+#include "LHCbMath/Choose.h"
+#include "LHCbMath/ChooseCache.h"
+// ============================================================================
+/** @file
+ *  Bounded concurrent memoization of the binomial coefficients
+ */
+// ============================================================================
+namespace {
+// ==========================================================================
+/** The word of the entry: the key in the low bits, then the sequence
+ *  counter, odd while a writer fills the entry:
+ *  - bits 0-15  : k
+ *  - bits 16-31 : n
+ *  - bits 32-34 : the function
+ *  - bit  35    : set for the used entries
+ *  - bits 36-63 : the sequence counter
+ */
+const std::uint64_t s_used = std::uint64_t(1) << 35;
+const unsigned int s_seq_shift = 36;
+const std::uint64_t s_busy = std::uint64_t(1) << s_seq_shift;
+const std::uint64_t s_key_mask = s_busy - 1;
+/// the number of entries in the shard
+const unsigned int s_ways = 4;
+// ==========================================================================
+/// the counters of this thread
+thread_local Math::BinomialCache::Counters s_counters = {0, 0};
+// ==========================================================================
+inline std::uint64_t _bits_(const double x) {
+  std::uint64_t b;
+  std::memcpy(&b, &x, sizeof(b));
+  return b;
+}
+inline double _double_(const std::uint64_t b) {
+  double x;
+  std::memcpy(&x, &b, sizeof(x));
+  return x;
+}
+// ==========================================================================
+}
+// ============================================================================
+/// the shard: the entries of one cache line
+struct Math::BinomialCache::Shard {
+  // ==========================================================================
+  /// the word and the bits of the value
+  struct Entry {
+    std::atomic<std::uint64_t> word;
+    std::atomic<std::uint64_t> value;
+  };
+  // ==========================================================================
+  Shard() {
+    for (Entry &e : entries) {
+      e.word.store(0, std::memory_order_relaxed);
+      e.value.store(0, std::memory_order_relaxed);
+    }
+  }
+  // ==========================================================================
+  Entry entries[s_ways];
+  // ==========================================================================
+};
+// ============================================================================
+Math::BinomialCache::BinomialCache(const std::size_t max_bytes)
+    : m_shards(nullptr), m_mask(0) {
+  static_assert(64 == sizeof(Shard), "BinomialCache: wrong size of the shard");
+  std::size_t n = 1;
+  while (2 * n * sizeof(Shard) <= max_bytes) {
+    n *= 2;
+  }
+  m_mask = n - 1;
+  //
+  void *p = nullptr;
+  if (0 != posix_memalign(&p, 64, n * sizeof(Shard))) {
+    throw std::bad_alloc();
+  }
+  m_shards = static_cast<Shard *>(p);
+  for (std::size_t i = 0; i < n; ++i) {
+    new (m_shards + i) Shard();
+  }
+}
+// ============================================================================
+Math::BinomialCache::~BinomialCache() { std::free(m_shards); }
+// ============================================================================
+void Math::BinomialCache::clear() {
+  for (std::size_t i = 0; i <= m_mask; ++i) {
+    for (Shard::Entry &e : m_shards[i].entries) {
+      std::uint64_t w = e.word.load(std::memory_order_relaxed);
+      // unused with the next even counter: the entries being written stay
+      while (0 == (w & s_busy) &&
+             !e.word.compare_exchange_weak(
+                 w, ((w >> s_seq_shift) + 2) << s_seq_shift,
+                 std::memory_order_release, std::memory_order_relaxed)) {
+      }
+    }
+  }
+}
+// ============================================================================
+/*  The lookup is the reader of the seqlock: the word before and after the
+ *  value must be the same even word with the key. On a miss the value is
+ *  computed and written unless another writer holds the entry.
+ */
+// ============================================================================
+template <class FUNCTOR>
+double Math::BinomialCache::_get_(const Function f, const unsigned short n,
+                                  const unsigned short k, FUNCTOR compute) {
+  const std::uint64_t key =
+      s_used | std::uint64_t(f) << 32 | std::uint64_t(n) << 16 | k;
+  const std::uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+  Shard &shard = m_shards[(h >> 32) & m_mask];
+  //
+  for (Shard::Entry &e : shard.entries) {
+    const std::uint64_t w = e.word.load(std::memory_order_acquire);
+    if ((w & (s_key_mask | s_busy)) != key) {
+      continue;
+    }
+    const std::uint64_t v = e.value.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (e.word.load(std::memory_order_relaxed) == w) {
+      ++s_counters.hits;
+      return _double_(v);
+    }
+  }
+  //
+  const double r = compute();
+  // an unused entry, otherwise the victim rotates with the misses
+  Shard::Entry *victim = &shard.entries[s_counters.misses % s_ways];
+  for (Shard::Entry &e : shard.entries) {
+    if (0 == (e.word.load(std::memory_order_relaxed) & s_used)) {
+      victim = &e;
+      break;
+    }
+  }
+  ++s_counters.misses;
+  //
+  std::uint64_t w = victim->word.load(std::memory_order_relaxed);
+  if (0 == (w & s_busy) &&
+      victim->word.compare_exchange_strong(w, w | s_busy,
+                                           std::memory_order_relaxed)) {
+    std::atomic_thread_fence(std::memory_order_release);
+    victim->value.store(_bits_(r), std::memory_order_relaxed);
+    victim->word.store(((w >> s_seq_shift) + 2) << s_seq_shift | key,
+                       std::memory_order_release);
+  }
+  return r;
+}
+// ============================================================================
+double Math::BinomialCache::choose_double(const unsigned short n,
+                                          const unsigned short k,
+                                          Math::stirling) {
+  return _get_(ChooseStirling, n, k, [n, k] {
+    return Math::choose_double(n, k, Math::stirling());
+  });
+}
+// ============================================================================
+double Math::BinomialCache::choose_double(const unsigned short n,
+                                          const unsigned short k,
+                                          Math::standard) {
+  return _get_(ChooseStandard, n, k,
+               [n, k] { return Math::choose_double(n, k); });
+}
+// ============================================================================
+double Math::BinomialCache::choose_double(const unsigned short n,
+                                          const unsigned short k,
+                                          Math::exact) {
+  return _get_(ChooseExact, n, k,
+               [n, k] { return Math::choose_double(n, k, Math::exact()); });
+}
+// ============================================================================
+double Math::BinomialCache::log_choose(const unsigned short n,
+                                       const unsigned short k, Math::stirling) {
+  return _get_(LogStirling, n, k,
+               [n, k] { return Math::log_choose(n, k, Math::stirling()); });
+}
+// ============================================================================
+double Math::BinomialCache::log_choose(const unsigned short n,
+                                       const unsigned short k,
+                                       Math::standard) {
+  return _get_(LogStandard, n, k,
+               [n, k] { return Math::log_choose(n, k); });
+}
+// ============================================================================
+double Math::BinomialCache::log_choose(const unsigned short n,
+                                       const unsigned short k, Math::exact) {
+  return _get_(LogExact, n, k,
+               [n, k] { return Math::log_choose(n, k, Math::exact()); });
+}
+// ============================================================================
+Math::BinomialCache::Counters Math::BinomialCache::counters() {
+  return s_counters;
+}
+// ============================================================================
+void Math::BinomialCache::reset_counters() { s_counters = {0, 0}; }
+// ============================================================================
+// The END
+// ============================================================================
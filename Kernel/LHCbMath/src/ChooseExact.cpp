@@ -0,0 +1,289 @@
+// ============================================================================
+// Include files
+// ============================================================================
+// STD/STL
+// ============================================================================
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+// ============================================================================
+// local
+// ============================================================================
+#include "LHCbMath/Choose.h"
+#include "LHCbMath/ChooseExact.h"
+// ============================================================================
+/** @file
+ *  Exact binomial coefficients of arbitrary size
+ */
+// ============================================================================
+namespace {
+// ==========================================================================
+typedef Math::BigUInt::Limb Limb;
+typedef std::vector<Limb> Limbs;
+// ==========================================================================
+/// below this number of limbs the schoolbook multiplication is used
+const std::size_t s_karatsuba = 32;
+/// below this number of leaves the product tree is multiplied sequentially
+const std::size_t s_leaves = 16;
+// ==========================================================================
+/// remove the leading zeros
+inline void _trim_(Limbs &a) {
+  while (!a.empty() && 0 == a.back()) {
+    a.pop_back();
+  }
+}
+// ==========================================================================
+/// out[0..na+nb) += a[0..na) * b[0..nb), schoolbook
+void _mul_school_(const Limb *a, const std::size_t na, const Limb *b,
+                  const std::size_t nb, Limb *out) {
+  for (std::size_t i = 0; i < na; ++i) {
+    Limb carry = 0;
+    for (std::size_t j = 0; j < nb; ++j) {
+      const Math::UINT128 t =
+          (Math::UINT128)a[i] * b[j] + out[i + j] + carry;
+      out[i + j] = (Limb)t;
+      carry = (Limb)(t >> 64);
+    }
+    for (std::size_t j = i + nb; carry; ++j) {
+      const Math::UINT128 t = (Math::UINT128)out[j] + carry;
+      out[j] = (Limb)t;
+      carry = (Limb)(t >> 64);
+    }
+  }
+}
+// ==========================================================================
+/// out[shift..] += a, out must be large enough
+void _add_to_(Limbs &out, const Limbs &a, const std::size_t shift) {
+  Limb carry = 0;
+  std::size_t i = 0;
+  for (; i < a.size(); ++i) {
+    const Math::UINT128 t = (Math::UINT128)out[shift + i] + a[i] + carry;
+    out[shift + i] = (Limb)t;
+    carry = (Limb)(t >> 64);
+  }
+  for (i += shift; carry; ++i) {
+    const Math::UINT128 t = (Math::UINT128)out[i] + carry;
+    out[i] = (Limb)t;
+    carry = (Limb)(t >> 64);
+  }
+}
+// ==========================================================================
+/// a -= b, a>=b
+void _sub_from_(Limbs &a, const Limbs &b) {
+  Limb borrow = 0;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    const Limb bi = i < b.size() ? b[i] : 0;
+    if (i >= b.size() && 0 == borrow) {
+      break;
+    }
+    const Limb d = a[i] - bi - borrow;
+    borrow = (a[i] < bi || (a[i] == bi && borrow)) ? 1 : 0;
+    a[i] = d;
+  }
+  _trim_(a);
+}
+// ==========================================================================
+/// a + b
+Limbs _add_(const Limb *a, const std::size_t na, const Limb *b,
+            const std::size_t nb) {
+  Limbs r(std::max(na, nb) + 1, 0);
+  std::copy(a, a + na, r.begin());
+  _add_to_(r, Limbs(b, b + nb), 0);
+  _trim_(r);
+  return r;
+}
+// ==========================================================================
+/// a * b, Karatsuba for large numbers
+Limbs _mul_(const Limb *a, std::size_t na, const Limb *b, std::size_t nb) {
+  if (na < nb) {
+    std::swap(a, b);
+    std::swap(na, nb);
+  }
+  if (0 == nb) {
+    return Limbs();
+  }
+  //
+  Limbs r(na + nb, 0);
+  if (nb < s_karatsuba) {
+    _mul_school_(a, na, b, nb, r.data());
+  } else if (2 * nb <= na) {
+    // unbalanced: multiply b by the chunks of a
+    for (std::size_t i = 0; i < na; i += nb) {
+      const Limbs p = _mul_(a + i, std::min(nb, na - i), b, nb);
+      _add_to_(r, p, i);
+    }
+  } else {
+    // a = a1*B^m + a0, b = b1*B^m + b0
+    const std::size_t m = na / 2;
+    const Limbs z0 = _mul_(a, m, b, m);
+    const Limbs z2 = _mul_(a + m, na - m, b + m, nb - m);
+    const Limbs sa = _add_(a, m, a + m, na - m);
+    const Limbs sb = _add_(b, m, b + m, nb - m);
+    Limbs z1 = _mul_(sa.data(), sa.size(), sb.data(), sb.size());
+    _sub_from_(z1, z0);
+    _sub_from_(z1, z2);
+    _add_to_(r, z0, 0);
+    _add_to_(r, z1, m);
+    _add_to_(r, z2, 2 * m);
+  }
+  _trim_(r);
+  return r;
+}
+// ==========================================================================
+/// the product of the leaves [first,last)
+Math::BigUInt _product_(const Limb *first, const Limb *last) {
+  const std::size_t size = last - first;
+  if (size <= s_leaves) {
+    Math::BigUInt r(1);
+    for (; first != last; ++first) {
+      r *= *first;
+    }
+    return r;
+  }
+  //
+  const Limb *middle = first + size / 2;
+  return _product_(first, middle) * _product_(middle, last);
+}
+// ==========================================================================
+/// exponent of the prime p in n! (Legendre's formula)
+inline unsigned int _legendre_(unsigned int n, const unsigned int p) {
+  unsigned int e = 0;
+  while (n) {
+    n /= p;
+    e += n;
+  }
+  return e;
+}
+// ==========================================================================
+}
+// ============================================================================
+Math::BigUInt::BigUInt(const UINT128 value) : m_limbs() {
+  if (value) {
+    m_limbs.push_back((Limb)value);
+  }
+  if (value >> 64) {
+    m_limbs.push_back((Limb)(value >> 64));
+  }
+}
+// ============================================================================
+std::size_t Math::BigUInt::bits() const {
+  if (m_limbs.empty()) {
+    return 0;
+  }
+  std::size_t n = 64 * m_limbs.size();
+  for (Limb top = m_limbs.back(); !(top >> 63); top <<= 1) {
+    --n;
+  }
+  return n;
+}
+// ============================================================================
+Math::BigUInt Math::BigUInt::operator*(const BigUInt &right) const {
+  BigUInt r;
+  r.m_limbs = _mul_(m_limbs.data(), m_limbs.size(), right.m_limbs.data(),
+                    right.m_limbs.size());
+  return r;
+}
+// ============================================================================
+Math::BigUInt &Math::BigUInt::operator*=(const Limb right) {
+  Limb carry = 0;
+  for (Limb &l : m_limbs) {
+    const UINT128 t = (UINT128)l * right + carry;
+    l = (Limb)t;
+    carry = (Limb)(t >> 64);
+  }
+  if (carry) {
+    m_limbs.push_back(carry);
+  }
+  _trim_(m_limbs);
+  return *this;
+}
+// ============================================================================
+double Math::BigUInt::to_double() const {
+  const std::size_t nbits = bits();
+  if (nbits <= 64) {
+    return m_limbs.empty() ? 0 : m_limbs[0];
+  }
+  // the top 64 bits, the lowest of them made sticky for the rest:
+  // with 11 extra bits the rounding of the conversion stays correct
+  const std::size_t shift = nbits - 64;
+  const std::size_t i = shift / 64;
+  const unsigned int s = shift % 64;
+  Limb top = m_limbs[i] >> s;
+  if (s) {
+    top |= m_limbs[i + 1] << (64 - s);
+  }
+  bool sticky = s && 0 != (m_limbs[i] << (64 - s));
+  for (std::size_t j = 0; j < i && !sticky; ++j) {
+    sticky = 0 != m_limbs[j];
+  }
+  return std::ldexp((double)(top | (sticky ? 1 : 0)), (int)shift);
+}
+// ============================================================================
+std::string Math::BigUInt::to_string() const {
+  if (m_limbs.empty()) {
+    return "0";
+  }
+  // repeated division by 10^19
+  const Limb base = 10000000000000000000ULL;
+  Limbs a = m_limbs;
+  std::vector<Limb> chunks;
+  while (!a.empty()) {
+    Limb rem = 0;
+    for (std::size_t i = a.size(); i-- > 0;) {
+      const UINT128 t = ((UINT128)rem << 64) | a[i];
+      a[i] = (Limb)(t / base);
+      rem = (Limb)(t % base);
+    }
+    _trim_(a);
+    chunks.push_back(rem);
+  }
+  std::string r = std::to_string(chunks.back());
+  for (std::size_t i = chunks.size() - 1; i-- > 0;) {
+    const std::string c = std::to_string(chunks[i]);
+    r += std::string(19 - c.size(), '0') + c;
+  }
+  return r;
+}
+// ============================================================================
+/*  calculate the exact binomial coefficient C(n,k) = n!/((n-k)!*k!)
+ */
+// ============================================================================
+Math::BigUInt Math::choose_exact(const unsigned short n,
+                                 const unsigned short k) {
+  if (k > n) {
+    return BigUInt(0);
+  }
+  const unsigned short k1 = 2 * k < n ? k : n - k;
+  //
+  // the sieve of Eratosthenes
+  std::vector<char> composite(n + 1, 0);
+  // the prime powers, packed into limbs
+  std::vector<Limb> leaves;
+  Limb leaf = 1;
+  for (unsigned int p = 2; p <= n; ++p) {
+    if (composite[p]) {
+      continue;
+    }
+    for (unsigned int q = p * p; q <= n; q += p) {
+      composite[q] = 1;
+    }
+    const unsigned int e =
+        _legendre_(n, p) - _legendre_(k1, p) - _legendre_(n - k1, p);
+    for (unsigned int i = 0; i < e; ++i) {
+      if (leaf > ~Limb(0) / p) {
+        leaves.push_back(leaf);
+        leaf = 1;
+      }
+      leaf *= p;
+    }
+  }
+  leaves.push_back(leaf);
+  //
+  return _product_(leaves.data(), leaves.data() + leaves.size());
+}
+// ============================================================================
+// The END
+// ============================================================================
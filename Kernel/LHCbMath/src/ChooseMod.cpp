@@ -0,0 +1,158 @@
+// ============================================================================
+// Include files
+// ============================================================================
+// STD/STL
+// ============================================================================
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+// ============================================================================
+// local
+// ============================================================================
+#include "LHCbMath/ChooseMod.h"
+// ============================================================================
+/** @file
+ *  Binomial coefficients modulo a prime
+ */
+// ============================================================================
+namespace {
+// ==========================================================================
+/// a*b mod p
+inline std::uint32_t _mul_(const std::uint64_t a, const std::uint64_t b,
+                           const std::uint32_t p) {
+  return (std::uint32_t)(a * b % p);
+}
+// ==========================================================================
+/// a^e mod p
+inline std::uint32_t _pow_(std::uint64_t a, std::uint32_t e,
+                           const std::uint32_t p) {
+  std::uint64_t r = 1 % p;
+  for (a %= p; e; e >>= 1) {
+    if (e % 2) {
+      r = _mul_(r, a, p);
+    }
+    a = _mul_(a, a, p);
+  }
+  return (std::uint32_t)r;
+}
+// ==========================================================================
+}
+// ============================================================================
+Math::ChooseMod::ChooseMod(const std::uint32_t p)
+    : m_p(p), m_fact(), m_inv() {
+  if (p < 2 || p > s_pmax) {
+    throw std::invalid_argument("Math::ChooseMod: the prime is out of range");
+  }
+  const std::uint32_t size = p;
+  m_fact.resize(size);
+  m_inv.resize(size);
+  m_fact[0] = 1 % p;
+  for (std::uint32_t i = 1; i < size; ++i) {
+    m_fact[i] = _mul_(m_fact[i - 1], i, p);
+  }
+  // Fermat's little theorem for the last one, then backwards
+  m_inv[size - 1] = _pow_(m_fact[size - 1], p - 2, p);
+  for (std::uint32_t i = size - 1; 0 < i; --i) {
+    m_inv[i - 1] = _mul_(m_inv[i], i, p);
+  }
+}
+// ============================================================================
+std::uint32_t Math::ChooseMod::small(const std::uint32_t n,
+                                     const std::uint32_t k) const {
+  return k > n ? 0
+               : _mul_(_mul_(m_fact[n], m_inv[k], m_p), m_inv[n - k], m_p);
+}
+// ============================================================================
+std::uint32_t Math::ChooseMod::operator()(std::uint64_t n,
+                                          std::uint64_t k) const {
+  if (k > n) {
+    return 0;
+  } else if (n < m_p) {
+    return small(n, k);
+  }
+  // Lucas' theorem: the product over the digits in base p
+  std::uint64_t r = 1 % m_p;
+  for (; k && r; n /= m_p, k /= m_p) {
+    r = _mul_(r, small(n % m_p, k % m_p), m_p);
+  }
+  return r;
+}
+// ============================================================================
+void Math::ChooseMod::operator()(const std::uint64_t *n,
+                                 const std::uint64_t *k, std::uint32_t *out,
+                                 const std::size_t size) const {
+  for (std::size_t i = 0; i < size; ++i) {
+    out[i] = (*this)(n[i], k[i]);
+  }
+}
+// ============================================================================
+namespace {
+// ==========================================================================
+/// the memory of the shared tables, at least two of the largest prime
+const std::size_t s_budget = std::size_t(64) << 20;
+// ==========================================================================
+/// the memory of the tables for the prime p
+inline std::size_t _bytes_(const std::uint32_t p) {
+  return 2 * sizeof(std::uint32_t) * std::size_t(p);
+}
+// ==========================================================================
+/** the tables for the prime p, shared by all threads: the least recently
+ *  used ones are released when the new ones exceed the budget. They are
+ *  built outside of the lock, the callers keep them alive while in use.
+ */
+std::shared_ptr<const Math::ChooseMod> _tables_(const std::uint32_t p) {
+  typedef std::shared_ptr<const Math::ChooseMod> Tables;
+  static std::mutex s_mutex;
+  static std::vector<Tables> s_tables; // the most recently used last
+  {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    for (std::size_t i = s_tables.size(); 0 < i; --i) {
+      if (p == s_tables[i - 1]->prime()) {
+        Tables t = s_tables[i - 1];
+        s_tables.erase(s_tables.begin() + (i - 1));
+        s_tables.push_back(t);
+        return t;
+      }
+    }
+  }
+  Tables t = std::make_shared<const Math::ChooseMod>(p);
+  std::lock_guard<std::mutex> lock(s_mutex);
+  std::size_t bytes = _bytes_(p);
+  for (const Tables &s : s_tables) {
+    if (p == s->prime()) {
+      return s; // built meanwhile by another thread
+    }
+    bytes += _bytes_(s->prime());
+  }
+  while (!s_tables.empty() && s_budget < bytes) {
+    bytes -= _bytes_(s_tables.front()->prime());
+    s_tables.erase(s_tables.begin());
+  }
+  s_tables.push_back(t);
+  return t;
+}
+// ==========================================================================
+}
+// ============================================================================
+/*  calculate the binomial coefficient C(n,k) modulo the prime p
+ */
+// ============================================================================
+std::uint32_t Math::choose_mod(const std::uint64_t n, const std::uint64_t k,
+                               const std::uint32_t p) {
+  return (*_tables_(p))(n, k);
+}
+// ============================================================================
+/*  calculate the binomial coefficients C(n[i],k[i]) modulo the prime p
+ */
+// ============================================================================
+void Math::choose_mod(const std::uint64_t *n, const std::uint64_t *k,
+                      std::uint32_t *out, const std::size_t size,
+                      const std::uint32_t p) {
+  (*_tables_(p))(n, k, out, size);
+}
+// ============================================================================
+// The END
+// ============================================================================
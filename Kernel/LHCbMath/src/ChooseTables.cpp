@@ -0,0 +1,46 @@
+// ============================================================================
+// Include files
+// ============================================================================
+// local
+// ============================================================================
+#include "LHCbMath/ChooseInline.h"
+// ============================================================================
+/** @file
+ *  The constant tables of the binomial coefficients, evaluated at compile
+ *  time in this file only
+ */
+// ============================================================================
+namespace {
+// ==========================================================================
+using namespace Math::Inline::detail;
+// ==========================================================================
+constexpr Pascal s_pascal{};
+constexpr Pascal128 s_pascal128{};
+static_assert(s_pascal(67, 33) == 14226520737620288370ULL,
+              "Pascal: wrong C(67,33)");
+static_assert(s_pascal.fits(65535, 4) && !s_pascal.fits(18581, 5),
+              "Pascal: wrong frontier");
+static_assert(s_pascal128(67, 33) == s_pascal(67, 33) &&
+                  !s_pascal128.fits(132, 65),
+              "Pascal128: wrong table");
+// the overflow edge: the unscaled products a*(a-1) and a^5 overflow
+static_assert(Math::Constexpr::gen_choose(1.8e154, 2) == 1.62e308 &&
+                  Math::Constexpr::gen_choose(-1.8e154, 2) == 1.62e308 &&
+                  Math::Constexpr::gen_choose(5e61, 5) ==
+                      2.604166666666667e306,
+              "Constexpr::gen_choose: wrong C(a,k) near DBL_MAX");
+// ==========================================================================
+}
+// ============================================================================
+alignas(64) const Pascal Math::Inline::detail::ChooseTables::pascal = s_pascal;
+alignas(64) const Pascal128 Math::Inline::detail::ChooseTables::pascal128 =
+    s_pascal128;
+const Reciprocals<unsigned long long, Pascal::kmax>
+    Math::Inline::detail::ChooseTables::reciprocals{};
+const Reciprocals<Math::UINT128, Pascal128::kmax>
+    Math::Inline::detail::ChooseTables::reciprocals128{};
+alignas(64) constexpr double
+    Math::Inline::detail::ChooseTables::stirling_delta[32];
+// ============================================================================
+// The END
+// ============================================================================
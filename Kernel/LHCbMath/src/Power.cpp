@@ -0,0 +1,132 @@
+// ============================================================================
+// Include files
+// ============================================================================
+// STD/STL
+// ============================================================================
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+// ============================================================================
+// local
+// ============================================================================
+#include "LHCbMath/MathKernels.h"
+#include "LHCbMath/Power.h"
+// ============================================================================
+/** @file
+ *  The integer powers of arrays
+ */
+// ============================================================================
+namespace {
+// ==========================================================================
+/// the block size: the squares of the block stay in L1
+const std::size_t s_block = 64;
+// ==========================================================================
+/** out[i] = x[i]^n for i<s_block: the square-and-multiply of pow(x,n)
+ *  with the loop over the bits of n outside, the loops over the block
+ *  inside vectorize
+ */
+LHCBMATH_TARGET_CLONES
+void _pow_block_(const double *x, const unsigned long n, double *out) {
+  double s[s_block];
+  for (std::size_t i = 0; i < s_block; ++i) {
+    s[i] = x[i];
+    out[i] = n % 2 ? x[i] : 1;
+  }
+  for (unsigned long m = n >> 1; m; m >>= 1) {
+    for (std::size_t i = 0; i < s_block; ++i) {
+      s[i] = s[i] * s[i];
+    }
+    if (m % 2) {
+      for (std::size_t i = 0; i < s_block; ++i) {
+        out[i] = out[i] * s[i];
+      }
+    }
+  }
+}
+// ==========================================================================
+/** out[i] = x[i]^n[i] for i<s_block: the square-and-multiply over the bits
+ *  of all n[i], each lane keeps the product only for its own bits
+ */
+LHCBMATH_TARGET_CLONES
+void _pow_block_(const double *x, const unsigned long *n, double *out) {
+  using Math::Kernels::_bits_;
+  using Math::Kernels::_double_;
+  unsigned long bits = 0;
+  double s[s_block];
+  for (std::size_t i = 0; i < s_block; ++i) {
+    bits |= n[i];
+    s[i] = x[i];
+    out[i] = 1;
+  }
+  unsigned int b = 0;
+  for (unsigned long m = bits; m; m >>= 1, ++b) {
+    LHCBMATH_UNROLL(4)
+    for (std::size_t i = 0; i < s_block; ++i) {
+      const std::uint64_t take = -std::uint64_t(n[i] >> b & 1);
+      const double p = out[i] * s[i];
+      out[i] = _double_((_bits_(p) & take) | (_bits_(out[i]) & ~take));
+      s[i] = s[i] * s[i];
+    }
+  }
+}
+// ==========================================================================
+/// apply the block kernel to the arrays, the last block padded with ones
+void _pow_blocks_(const double *x, const unsigned long n, double *out,
+                  const std::size_t size) {
+  std::size_t i0 = 0;
+  for (; i0 + s_block <= size; i0 += s_block) {
+    _pow_block_(x + i0, n, out + i0);
+  }
+  if (i0 == size) {
+    return;
+  }
+  const std::size_t m = size - i0;
+  double xb[s_block];
+  double res[s_block];
+  std::fill(xb + m, xb + s_block, 1.0);
+  std::copy(x + i0, x + size, xb);
+  _pow_block_(xb, n, res);
+  std::copy(res, res + m, out + i0);
+}
+/// the same for the exponents per element, padded with zeros
+void _pow_blocks_(const double *x, const unsigned long *n, double *out,
+                  const std::size_t size) {
+  std::size_t i0 = 0;
+  for (; i0 + s_block <= size; i0 += s_block) {
+    _pow_block_(x + i0, n + i0, out + i0);
+  }
+  if (i0 == size) {
+    return;
+  }
+  const std::size_t m = size - i0;
+  double xb[s_block];
+  unsigned long nb[s_block];
+  double res[s_block];
+  std::fill(xb + m, xb + s_block, 1.0);
+  std::fill(nb + m, nb + s_block, 0ul);
+  std::copy(x + i0, x + size, xb);
+  std::copy(n + i0, n + size, nb);
+  _pow_block_(xb, nb, res);
+  std::copy(res, res + m, out + i0);
+}
+// ==========================================================================
+}
+// ============================================================================
+/*  out[i] = x[i]^n for i<size
+ */
+// ============================================================================
+void Math::pow(const double *x, const unsigned long n, double *out,
+               const std::size_t size) {
+  _pow_blocks_(x, n, out, size);
+}
+// ============================================================================
+/*  out[i] = x[i]^n[i] for i<size
+ */
+// ============================================================================
+void Math::pow(const double *x, const unsigned long *n, double *out,
+               const std::size_t size) {
+  _pow_blocks_(x, n, out, size);
+}
+// ============================================================================
+// The END
+// ============================================================================